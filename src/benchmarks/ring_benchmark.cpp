@@ -0,0 +1,104 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "srlz/array.hpp"
+#include "srlz/max_serialized_size.hpp"
+#include "srlz/ring.hpp"
+#include "srlz/serializable.hpp"
+
+using namespace srlz;
+
+class message final : public serializable
+{
+public:
+    virtual ~message() = default;
+    message() : serializable(member_vector) {}
+
+    member<int64_t, member_type::INT_64> timestamp;
+    member<array<uint8_t, 48>, member_type::SRLZ> payload;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&timestamp),
+        static_cast<void*>(&payload)
+    };
+
+    static constexpr size_t max_serialized_size = srlz::max_serialized_size<decltype(timestamp), decltype(payload)>();
+};
+
+int64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template<producer_mode pm>
+void run(const char* const name, const size_t producers, const size_t count)
+{
+    ring<pm> channel(size_t(1) << 20);
+    std::vector<std::thread> threads;
+    const int64_t start = now();
+
+    for (size_t p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&channel, count]
+        {
+            message m;
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                m.timestamp.set(now());
+
+                while (!channel.try_push(m))
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    std::vector<int64_t> latencies;
+    latencies.reserve(producers * count);
+    message m;
+
+    while (latencies.size() < producers * count)
+    {
+        if (!channel.try_pop(m))
+            continue;
+
+        latencies.push_back(now() - m.timestamp.get());
+    }
+
+    const int64_t elapsed = now() - start;
+
+    for (auto& thread : threads)
+        thread.join();
+
+    std::sort(latencies.begin(), latencies.end());
+
+    printf("%s producers %zu: %.2f M messages/s, latency p50 %lld ns, p99 %lld ns\n",
+        name, producers, double(latencies.size()) * 1e3 / double(elapsed),
+        static_cast<long long>(latencies[latencies.size() / 2]),
+        static_cast<long long>(latencies[latencies.size() * 99 / 100]));
+}
+
+int main()
+{
+    constexpr size_t count = 1000000;
+    const size_t cores = std::max(2U, std::thread::hardware_concurrency());
+
+    run<producer_mode::SINGLE>("spsc", 1, count);
+
+    for (size_t producers = 1; producers < cores; producers *= 2)
+        run<producer_mode::MULTIPLE>("mpsc", producers, count / producers);
+
+    return 0;
+}
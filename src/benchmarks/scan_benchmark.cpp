@@ -0,0 +1,98 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "srlz/columnar.hpp"
+#include "srlz/scan.hpp"
+#include "srlz/serializable.hpp"
+
+using namespace srlz;
+
+class record final : public serializable
+{
+public:
+    virtual ~record() = default;
+    record() : serializable(member_vector) {}
+
+    member<int32_t, member_type::INT_32> kind;
+    member<int64_t, member_type::INT_64> id;
+    member<double, member_type::DOUBLE> price;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&kind),
+        static_cast<void*>(&id),
+        static_cast<void*>(&price)
+    };
+};
+
+int64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template<typename T>
+void run(const char* const name, const column_view<T>& column, const predicate<T>& condition)
+{
+    constexpr int rounds = 20;
+    const char* const isa_names[] = { "scalar", "sse2", "avx2" };
+    std::vector<size_t> matches;
+    matches.reserve(column.size());
+
+    for (const auto isa : { scan_isa::SCALAR, scan_isa::SSE2, scan_isa::AVX2 })
+    {
+        if (isa > detect_scan_isa())
+            continue;
+
+        const int64_t start = now();
+        size_t found = 0;
+
+        for (int round = 0; round < rounds; ++round)
+        {
+            matches.clear();
+            found += scan(column, condition, matches, isa);
+        }
+
+        const int64_t elapsed = now() - start;
+
+        printf("%s %s: %.2f GB/s, %zu matches\n", name, isa_names[size_t(isa)],
+            double(column.size() * sizeof(T)) * rounds / double(elapsed), found / rounds);
+    }
+}
+
+int main()
+{
+    constexpr size_t count = 4 * 1024 * 1024;
+
+    columnar<record> batch;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        batch.push_back(std::make_unique<record>());
+        batch.back()->kind.set(int32_t(i * 2654435761U % 64));
+        batch.back()->id.set(int64_t(i));
+        batch.back()->price.set(double(i % 10000) / 100);
+    }
+
+    std::vector<uint64_t> storage(count * 3);
+    size_t offset = 0;
+    columnar<record>::view parsed;
+
+    batch.serialize(reinterpret_cast<char*>(storage.data()), storage.size() * sizeof(uint64_t), offset);
+    const size_t size = offset;
+    columnar<record>::parse(reinterpret_cast<char*>(storage.data()), size, offset = 0, parsed);
+
+    run("int32 equal", parsed.column<int32_t>(0), predicate<int32_t>::equal(7));
+    run("int64 range", parsed.column<int64_t>(1), predicate<int64_t>::range(1000, 2000));
+    run("double less", parsed.column<double>(2), predicate<double>::less(1.0));
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <tuple>
+#include <vector>
+
+#include "srlz/serializable.hpp"
+#include "srlz/static_serializable.hpp"
+#include "srlz/vector.hpp"
+
+using namespace srlz;
+
+constexpr int depth = 8;
+
+template<int N>
+class virtual_level final : public serializable
+{
+public:
+    virtual ~virtual_level() = default;
+    virtual_level() : serializable(member_vector) {}
+
+    member<int64_t, member_type::INT_64> id;
+    member<double, member_type::DOUBLE> value;
+    member<virtual_level<N - 1>, member_type::SRLZ> next;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&id),
+        static_cast<void*>(&value),
+        static_cast<void*>(&next)
+    };
+};
+
+template<>
+class virtual_level<0> final : public serializable
+{
+public:
+    virtual ~virtual_level() = default;
+    virtual_level() : serializable(member_vector) {}
+
+    member<int64_t, member_type::INT_64> id;
+    member<double, member_type::DOUBLE> value;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&id),
+        static_cast<void*>(&value)
+    };
+};
+
+template<int N>
+class static_level final : public static_serializable<static_level<N>>
+{
+public:
+    virtual ~static_level() = default;
+    static_level() : static_serializable<static_level<N>>(member_vector) {}
+
+    member<int64_t, member_type::INT_64> id;
+    member<double, member_type::DOUBLE> value;
+    member<static_level<N - 1>, member_type::SRLZ> next;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&id),
+        static_cast<void*>(&value),
+        static_cast<void*>(&next)
+    };
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(&static_level::id, &static_level::value, &static_level::next);
+    }
+};
+
+template<>
+class static_level<0> final : public static_serializable<static_level<0>>
+{
+public:
+    virtual ~static_level() = default;
+    static_level() : static_serializable(member_vector) {}
+
+    member<int64_t, member_type::INT_64> id;
+    member<double, member_type::DOUBLE> value;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&id),
+        static_cast<void*>(&value)
+    };
+
+    static constexpr auto members()
+    {
+        return std::make_tuple(&static_level::id, &static_level::value);
+    }
+};
+
+int64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template<typename T>
+void run(const char* const name, const T& value, const size_t rounds)
+{
+    std::vector<char> buffer(64);
+    size_t offset;
+
+    while (!value.serialize(buffer.data(), buffer.size(), offset = 0))
+        buffer.resize(buffer.size() * 2);
+
+    const size_t size = offset;
+    const T copy;
+    size_t failures = 0;
+
+    int64_t start = now();
+
+    for (size_t round = 0; round < rounds; ++round)
+        failures += !value.serialize(buffer.data(), buffer.size(), offset = 0);
+
+    const int64_t serialized = now() - start;
+
+    start = now();
+
+    for (size_t round = 0; round < rounds; ++round)
+        failures += !copy.deserialize(buffer.data(), size, offset = 0);
+
+    const int64_t deserialized = now() - start;
+
+    printf("%s: %zu bytes, serialize %.1f ns, deserialize %.1f ns%s\n", name, size,
+        double(serialized) / double(rounds), double(deserialized) / double(rounds), failures ? ", failed" : "");
+}
+
+int main()
+{
+    constexpr size_t count = 1024 * 1024;
+
+    run("virtual nested", virtual_level<depth>(), 1000000);
+    run("static nested", static_level<depth>(), 1000000);
+
+    vector<virtual_level<0>> virtual_points;
+    vector<static_level<0>> static_points;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        virtual_points.push_back(virtual_points.make_item());
+        virtual_points.back()->id.set(int64_t(i));
+        static_points.push_back(static_points.make_item());
+        static_points.back()->id.set(int64_t(i));
+    }
+
+    run("virtual vector", virtual_points, 10);
+    run("static vector", static_points, 10);
+
+    return 0;
+}
@@ -0,0 +1,107 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "srlz/serializable.hpp"
+#include "srlz/wal.hpp"
+
+using namespace srlz;
+
+class change final : public serializable
+{
+public:
+    virtual ~change() = default;
+    change() : serializable(member_vector) {}
+
+    member<int64_t, member_type::INT_64> key;
+    member<int64_t, member_type::INT_64> value;
+    member<double, member_type::DOUBLE> timestamp;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&key),
+        static_cast<void*>(&value),
+        static_cast<void*>(&timestamp)
+    };
+};
+
+int64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void run(const char* const path, const int thread_count, const int records_per_thread)
+{
+    unlink(path);
+
+    wal log(path);
+
+    if (!log.is_open())
+    {
+        printf("cannot open %s\n", path);
+
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    const int64_t start = now();
+
+    for (int t = 0; t < thread_count; ++t)
+        threads.emplace_back([&log, t, records_per_thread]()
+        {
+            change record;
+            record.key.set(t);
+
+            for (int i = 0; i < records_per_thread; ++i)
+            {
+                record.value.set(i);
+                record.timestamp.set(double(i));
+                log.append(record);
+            }
+        });
+
+    for (auto& thread : threads)
+        thread.join();
+
+    const int64_t elapsed = now() - start;
+    const double total = double(thread_count) * records_per_thread;
+
+    printf("%2d writers: %.0f records/s, %.1f us per append\n", thread_count,
+        total * 1e9 / double(elapsed), double(elapsed) * thread_count / total / 1e3);
+
+    const int64_t replay_start = now();
+    wal_reader reader(path);
+    wal_reader::record_view view;
+    change record;
+    size_t replayed = 0;
+
+    while (reader.next(view))
+        replayed += view.deserialize(record);
+
+    printf("%2d writers: replayed %zu records in %.1f ms\n", thread_count, replayed, double(now() - replay_start) / 1e6);
+}
+
+int main(int argc, char* argv[])
+{
+    const char* const path = argc > 1 ? argv[1] : "srlz_wal_benchmark.log";
+    const int records = argc > 2 ? std::atoi(argv[2]) : 20000;
+
+    for (const int thread_count : { 1, 4, 16 })
+        run(path, thread_count, records / thread_count);
+
+    unlink(path);
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_ARRAY_HPP
+#define SRLZ_ARRAY_HPP
+
+#include <array>
+
+#include "base.hpp"
+
+namespace srlz
+{
+
+/**
+ * @brief fixed extent array of fundamental types, written as one block without a length prefix,
+ * floating values are written one by one in a canonical_scope to normalize them
+ */
+template<typename _Tp, size_t _Nm>
+class array final : public base, public std::array<_Tp, _Nm>
+{
+    static_assert(std::is_arithmetic_v<_Tp>);
+
+public:
+    static constexpr size_t max_serialized_size = sizeof(_Tp) * _Nm;
+    static constexpr size_t min_serialized_size = max_serialized_size;
+
+    virtual ~array() = default;
+    array() = default;
+    array(const array&) = default;
+    array& operator=(const array&) = default;
+
+    virtual void describe_layout(xxh64& hash) const override
+    {
+        describe(hash, layout_tag::ARRAY);
+        describe_item<_Tp>(hash);
+        describe(hash, _Nm);
+    }
+
+    virtual size_t get_max_size() const noexcept override
+    {
+        return max_serialized_size;
+    }
+
+    virtual bool serialize(
+        char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const override
+    {
+        if (std::is_floating_point_v<_Tp> && canonical_scope::get())
+        {
+            for (const _Tp& item : *this)
+                if (!write_item(item, buffer, buffer_size, buffer_offset))
+                    return false;
+
+            return true;
+        }
+
+        return write(static_cast<const void*>(this->data()), max_serialized_size, buffer, buffer_size, buffer_offset);
+    }
+
+    virtual bool gather(iovec_list& list) const override
+    {
+        if (std::is_floating_point_v<_Tp> && canonical_scope::get())
+        {
+            unsigned char temporary[sizeof(long double)];
+
+            for (const _Tp& item : *this)
+                list.copy(canonical_scope::normalize(member_type_of<_Tp>(), &item, temporary), sizeof(_Tp));
+
+            return true;
+        }
+
+        list.append(static_cast<const void*>(this->data()), max_serialized_size);
+
+        return true;
+    }
+
+    virtual bool deserialize(
+        const char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const override
+    {
+        return read(static_cast<void*>(const_cast<_Tp*>(this->data())), max_serialized_size, buffer, buffer_size, buffer_offset);
+    }
+
+    virtual std::unique_ptr<part_cursor> encode_parts() const override
+    {
+        return make_cursor([this](const size_t index, value_part& part)
+        {
+            if (index > 0)
+                return part_cursor::step::END;
+
+            part = { nullptr, const_cast<_Tp*>(this->data()), max_serialized_size, member_type_of<_Tp>() };
+
+            return part_cursor::step::PART;
+        });
+    }
+
+    virtual std::unique_ptr<part_cursor> decode_parts() const override
+    {
+        return encode_parts();
+    }
+};
+
+} // namespace srlz
+
+#endif // SRLZ_ARRAY_HPP
@@ -0,0 +1,207 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_ASYNC_WRITER_HPP
+#define SRLZ_ASYNC_WRITER_HPP
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "base.hpp"
+
+namespace srlz
+{
+
+/**
+ * @brief serializes entities back to back into one of buffer_count rotating buffers,
+ * a buffer filled up to flush_threshold bytes is handed to a background thread which writes it to the file,
+ * producers wait only when every buffer is waiting for the disk
+ */
+class async_writer final
+{
+public:
+    async_writer(
+        const char* const path,
+        const size_t buffer_size = size_t(1) << 20,
+        const size_t buffer_count = 2,
+        const size_t flush_threshold = size_t(1) << 20
+        )
+        : flush_threshold(flush_threshold < buffer_size ? flush_threshold : buffer_size)
+        , file(std::fopen(path, "wb"))
+        , buffers(buffer_count < 2 ? 2 : buffer_count, buffer{ std::vector<char>(buffer_size), 0 })
+    {
+        if (!file)
+            return;
+
+        for (size_t i = 1; i < buffers.size(); ++i)
+            free_buffers.push_back(i);
+
+        io_thread = std::thread(&async_writer::io_loop, this);
+    }
+
+    ~async_writer()
+    {
+        close();
+    }
+
+    bool is_open() const noexcept
+    {
+        return file != nullptr;
+    }
+
+    /**
+     * @brief false if the writer is closed, a previous write to the file failed
+     * or the serialized entity does not fit an empty buffer
+     */
+    bool write(const base& entity)
+    {
+        std::unique_lock lock(mutex);
+
+        if (!file || failed)
+            return false;
+
+        size_t offset = buffers[current].size;
+        const size_t checkpoint = dictionary_scope::checkpoint();
+
+        if (!entity.serialize(buffers[current].data.data(), buffers[current].data.size(), offset))
+        {
+            dictionary_scope::rollback(checkpoint);
+
+            if (buffers[current].size == 0)
+                return false;
+
+            submit(lock);
+            offset = 0;
+
+            if (!entity.serialize(buffers[current].data.data(), buffers[current].data.size(), offset))
+            {
+                dictionary_scope::rollback(checkpoint);
+
+                return false;
+            }
+        }
+
+        buffers[current].size = offset;
+
+        if (buffers[current].size >= flush_threshold)
+            submit(lock);
+
+        return true;
+    }
+
+    /**
+     * @brief hands the current buffer to the background thread and waits until everything is written
+     */
+    bool flush()
+    {
+        std::unique_lock lock(mutex);
+
+        if (!file)
+            return false;
+
+        if (buffers[current].size > 0)
+            submit(lock);
+
+        condition.wait(lock, [this] { return full_buffers.empty() && !writing; });
+
+        if (std::fflush(file) != 0)
+            failed = true;
+
+        return !failed;
+    }
+
+    /**
+     * @brief flushes, stops the background thread and closes the file
+     */
+    bool close()
+    {
+        if (!file)
+            return false;
+
+        bool success = flush();
+
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+
+        condition.notify_all();
+        io_thread.join();
+
+        if (std::fclose(file) != 0)
+            success = false;
+
+        file = nullptr;
+
+        return success;
+    }
+
+private:
+    struct buffer
+    {
+        std::vector<char> data;
+        size_t size;
+    };
+
+    void submit(std::unique_lock<std::mutex>& lock)
+    {
+        full_buffers.push_back(current);
+        condition.notify_all();
+        condition.wait(lock, [this] { return !free_buffers.empty(); });
+        current = free_buffers.front();
+        free_buffers.pop_front();
+    }
+
+    void io_loop()
+    {
+        std::unique_lock lock(mutex);
+
+        while (true)
+        {
+            condition.wait(lock, [this] { return stopping || !full_buffers.empty(); });
+
+            if (full_buffers.empty())
+                return;
+
+            const size_t index = full_buffers.front();
+            full_buffers.pop_front();
+            writing = true;
+            lock.unlock();
+
+            auto& [data, size] = buffers[index];
+            const bool success = std::fwrite(data.data(), 1, size, file) == size;
+            size = 0;
+
+            lock.lock();
+            writing = false;
+            failed = failed || !success;
+            free_buffers.push_back(index);
+            condition.notify_all();
+        }
+    }
+
+    const size_t flush_threshold;
+    std::FILE* file;
+    std::vector<buffer> buffers;
+    size_t current = 0;
+    std::deque<size_t> free_buffers;
+    std::deque<size_t> full_buffers;
+    bool writing = false;
+    bool failed = false;
+    bool stopping = false;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::thread io_thread;
+};
+
+} // namespace srlz
+
+#endif // SRLZ_ASYNC_WRITER_HPP
@@ -8,14 +8,56 @@
 #ifndef SRLZ_BASE_HPP
 #define SRLZ_BASE_HPP
 
+#include <cstring>
+#include <limits>
+#include <memory>
 #include <type_traits>
+#include <vector>
+
+#include "canonical.hpp"
+#include "dictionary.hpp"
+#include "footprint.hpp"
+#include "iovec_list.hpp"
+#include "limits.hpp"
+#include "parts.hpp"
 
 namespace srlz
 {
 
+class serializable;
+
+template<typename T, typename = void>
+struct has_min_serialized_size : std::false_type {};
+
+template<typename T>
+struct has_min_serialized_size<T, std::void_t<decltype(T::min_serialized_size)>> : std::true_type {};
+
+/**
+ * @brief tags of the structural description of a type, see base::describe_layout()
+ */
+enum class layout_tag : uint8_t
+{
+    OPAQUE,
+    ENTITY,
+    CUSTOM_ENTITY,
+    END,
+    RECURSIVE,
+    STRING,
+    MEMORY,
+    BLOB,
+    ARRAY,
+    VARIANT,
+    VECTOR,
+    MAP,
+    UNORDERED_MAP,
+    COLUMNAR
+};
+
 class base
 {
 public:
+    static constexpr size_t variable_size = std::numeric_limits<size_t>::max();
+
     virtual ~base() = default;
 
     virtual bool serialize(
@@ -30,7 +72,86 @@ public:
         size_t& buffer_offset
         ) const = 0;
 
+    /**
+     * @brief appends the serialized bytes to list, large payloads are referenced in place,
+     * the default implementation serializes into a temporary buffer and copies it
+     */
+    virtual bool gather(iovec_list& list) const
+    {
+        std::vector<char> temporary(64);
+        const size_t checkpoint = dictionary_scope::checkpoint();
+        size_t offset;
+
+        while (!serialize(temporary.data(), temporary.size(), offset = 0))
+        {
+            dictionary_scope::rollback(checkpoint);
+
+            if (temporary.size() >= max_gather_fallback_size)
+                return false;
+
+            temporary.resize(temporary.size() * 2);
+        }
+
+        list.copy(temporary.data(), offset);
+
+        return true;
+    }
+
+    /**
+     * @brief heap memory owned by the value, the value itself is counted by whoever allocated it,
+     * the default implementation owns nothing
+     */
+    virtual footprint get_footprint() const
+    {
+        return {};
+    }
+
+    /**
+     * @brief the serialized size when every member has a value, variable_size unless the layout is fixed,
+     * the default implementation has no fixed layout
+     */
+    virtual size_t get_max_size() const noexcept
+    {
+        return variable_size;
+    }
+
+    /**
+     * @brief the parts of the serialized value for streaming, see chunked.hpp,
+     * nullptr if the value is streamed as one block, which the default implementation does
+     */
+    virtual std::unique_ptr<part_cursor> encode_parts() const
+    {
+        return nullptr;
+    }
+
+    /**
+     * @brief the parts to read the value into, in the order of encode_parts, nullptr by default
+     */
+    virtual std::unique_ptr<part_cursor> decode_parts() const
+    {
+        return nullptr;
+    }
+
+    /**
+     * @brief feeds the structure of the serialized type to hash, so a stored layout is recognized without type names,
+     * the default implementation describes an opaque type
+     */
+    virtual void describe_layout(xxh64& hash) const
+    {
+        describe(hash, layout_tag::OPAQUE);
+    }
+
+    /**
+     * @brief points the entities stored in the value at parent, whose cache a change of any of them invalidates,
+     * nullptr unlinks them, called by an entity which is cached or nested in a cached one, the default implementation stores none
+     */
+    virtual void link_entities(const serializable* const) const
+    {
+    }
+
 protected:
+    static constexpr size_t max_gather_fallback_size = size_t(1) << 30;
+
     bool write(
         const void* const value,
         const size_t value_length,
@@ -39,7 +160,7 @@ protected:
         size_t& buffer_offset
         ) const
     {
-        if (buffer_offset + value_length > buffer_size)
+        if (buffer_offset > buffer_size || value_length > buffer_size - buffer_offset)
             return false;
 
         std::memcpy(buffer + buffer_offset, value, value_length);
@@ -56,7 +177,7 @@ protected:
         size_t& buffer_offset
         ) const
     {
-        if (buffer_offset + value_length > buffer_size)
+        if (buffer_offset > buffer_size || value_length > buffer_size - buffer_offset)
             return false;
 
         std::memcpy(value, buffer + buffer_offset, value_length);
@@ -64,8 +185,239 @@ protected:
 
         return true;
     };
+
+    /**
+     * @brief checks a length prefix against the bytes left after it, every element takes at least item_size bytes,
+     * so a corrupted length is rejected before anything is allocated, elements which may take no bytes at all
+     * pass with any length and are bounded by limits_scope only
+     */
+    static bool check_length(
+        const size_t length,
+        const size_t item_size,
+        const size_t buffer_size,
+        const size_t buffer_offset
+        ) noexcept
+    {
+        return item_size == 0 || length <= (buffer_size - buffer_offset) / item_size;
+    }
+
+    /**
+     * @brief the fewest bytes an element of type T takes, a fundamental type takes its size,
+     * a srlz type its static constexpr min_serialized_size, 0 if it has none, like an entity without members
+     */
+    template<class T>
+    static constexpr size_t min_item_size() noexcept
+    {
+        if constexpr (std::is_arithmetic_v<T>)
+            return sizeof(T);
+        else if constexpr (has_min_serialized_size<T>::value)
+            return T::min_serialized_size;
+        else
+            return 0;
+    }
+
+    /**
+     * @brief writes a fundamental value as is, normalized in a canonical_scope, or serializes a srlz type
+     */
+    template<class T>
+    bool write_item(
+        const T& item,
+        char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const
+    {
+        static_assert(std::is_arithmetic_v<T> || std::is_base_of_v<base, T>);
+
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            unsigned char temporary[sizeof(long double)];
+            const void* const value = canonical_scope::get()
+                ? canonical_scope::normalize(member_type_of<T>(), &item, temporary) : &item;
+
+            return write(value, sizeof(T), buffer, buffer_size, buffer_offset);
+        }
+        else if constexpr (std::is_arithmetic_v<T>)
+            return write(static_cast<const void*>(&item), sizeof(T), buffer, buffer_size, buffer_offset);
+        else
+            return item.serialize(buffer, buffer_size, buffer_offset);
+    }
+
+    /**
+     * @brief reads a fundamental value as is or deserializes a srlz type
+     */
+    template<class T>
+    bool read_item(
+        T& item,
+        const char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const
+    {
+        static_assert(std::is_arithmetic_v<T> || std::is_base_of_v<base, T>);
+
+        if constexpr (std::is_arithmetic_v<T>)
+            return read(static_cast<void*>(&item), sizeof(T), buffer, buffer_size, buffer_offset);
+        else
+            return item.deserialize(buffer, buffer_size, buffer_offset);
+    }
+
+    /**
+     * @brief nothing for a fundamental value, the heap memory of a srlz type
+     */
+    template<class T>
+    static footprint footprint_of(const T& item)
+    {
+        if constexpr (std::is_base_of_v<base, T>)
+            return item.get_footprint();
+        else
+            return {};
+    }
+
+    /**
+     * @brief an entity created by a container is of type T itself and takes the plan of T, other values do nothing
+     */
+    template<class T>
+    static void plan_item(const T& item)
+    {
+        if constexpr (std::is_base_of_v<serializable, T>)
+            item.template use_class_plan<T>();
+    }
+
+    static void describe(xxh64& hash, const layout_tag tag) noexcept
+    {
+        hash.update(&tag, sizeof(tag));
+    }
+
+    static void describe(xxh64& hash, const size_t count) noexcept
+    {
+        const uint64_t value = count;
+
+        hash.update(&value, sizeof(value));
+    }
+
+    /**
+     * @brief a fundamental type by its member_type, a srlz type by the layout of a default constructed value,
+     * a type which contains itself is described once
+     */
+    template<class T>
+    static void describe_item(xxh64& hash)
+    {
+        static_assert(std::is_arithmetic_v<T> || std::is_base_of_v<base, T>);
+
+        if constexpr (std::is_arithmetic_v<T>)
+        {
+            const member_type type = member_type_of<T>();
+
+            hash.update(&type, sizeof(type));
+        }
+        else
+        {
+            static thread_local bool described = false;
+
+            if (described)
+            {
+                describe(hash, layout_tag::RECURSIVE);
+                return;
+            }
+
+            struct guard
+            {
+                guard() noexcept { described = true; }
+                ~guard() { described = false; }
+            } active;
+
+            T().describe_layout(hash);
+        }
+    }
+
+    template<class _Function>
+    static std::unique_ptr<part_cursor> make_cursor(_Function function)
+    {
+        return std::make_unique<function_cursor<_Function>>(std::move(function));
+    }
+
+    static value_part bytes_part(const void* const data, const size_t length) noexcept
+    {
+        return { nullptr, const_cast<void*>(data), length };
+    }
+
+    /**
+     * @brief the next part of a payload of length bytes to read after received ones, as large as the bytes received so far,
+     * so the storage for a payload grows with the bytes which arrive rather than with the length which was claimed
+     */
+    static size_t payload_slice(const size_t length, const size_t received) noexcept
+    {
+        constexpr size_t min_slice = 4096;
+
+        const size_t slice = received > min_slice ? received : min_slice;
+
+        return length - received < slice ? length - received : slice;
+    }
+
+    /**
+     * @brief a fundamental value as bytes of its type or a srlz type as a nested value
+     */
+    template<class T>
+    static value_part part_of(const T& item) noexcept
+    {
+        static_assert(std::is_arithmetic_v<T> || std::is_base_of_v<base, T>);
+
+        if constexpr (std::is_arithmetic_v<T>)
+            return { nullptr, const_cast<T*>(&item), sizeof(T), member_type_of<T>() };
+        else
+            return { &item };
+    }
+
+    /**
+     * @brief nothing for a fundamental value, links the entities of a srlz type
+     */
+    template<class T>
+    static void link_item(const T& item, const serializable* const parent)
+    {
+        if constexpr (std::is_base_of_v<base, T>)
+            item.link_entities(parent);
+    }
 };
 
+inline bool canonical_scope::serialize(const base& entity, char* const buffer, const size_t buffer_size, size_t& buffer_offset)
+{
+    const size_t start = buffer_offset;
+
+    if (!entity.serialize(buffer, buffer_size, buffer_offset))
+        return false;
+
+    if (hashing)
+        hash.update(buffer + start, buffer_offset - start);
+
+    return true;
+}
+
+inline bool canonical_scope::gather(const base& entity, iovec_list& list)
+{
+    size_t skipped = list.size();
+
+    if (!entity.gather(list))
+        return false;
+
+    if (!hashing)
+        return true;
+
+    for (auto& [data, length] : list.get_segments())
+    {
+        if (skipped >= length)
+        {
+            skipped -= length;
+            continue;
+        }
+
+        hash.update(static_cast<const char*>(data) + skipped, length - skipped);
+        skipped = 0;
+    }
+
+    return true;
+}
+
 } // namespace srlz
 
 #endif // SRLZ_BASE_HPP
@@ -0,0 +1,340 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_BLOB_HPP
+#define SRLZ_BLOB_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "base.hpp"
+
+namespace srlz
+{
+
+/**
+ * @brief owning byte buffer aligned to _Alignment, written as a length and the bytes,
+ * capacity is kept across deserializations, so a buffer only grows when a larger value arrives
+ */
+template<size_t _Alignment = alignof(std::max_align_t), typename _Alloc = std::allocator<unsigned char>>
+class blob final : public base
+{
+    static_assert(_Alignment > 0 && (_Alignment & (_Alignment - 1)) == 0);
+
+    struct alignas(_Alignment) block
+    {
+        unsigned char bytes[_Alignment];
+    };
+
+    using block_allocator = typename std::allocator_traits<_Alloc>::template rebind_alloc<block>;
+    using block_traits = std::allocator_traits<block_allocator>;
+
+public:
+    using allocator_type = _Alloc;
+
+    static constexpr size_t alignment = _Alignment;
+    static constexpr size_t min_serialized_size = sizeof(size_t);
+
+    virtual ~blob()
+    {
+        deallocate();
+    }
+
+    blob() = default;
+
+    explicit blob(const _Alloc& allocator) : allocator(allocator) {}
+
+    blob(const blob& other)
+        : allocator(block_traits::select_on_container_copy_construction(other.allocator))
+    {
+        assign(other.data(), other.size());
+    }
+
+    blob(blob&& other) noexcept
+        : allocator(std::move(other.allocator)),
+        storage(std::exchange(other.storage, nullptr)),
+        size_(std::exchange(other.size_, 0)),
+        capacity_(std::exchange(other.capacity_, 0))
+    {
+    }
+
+    blob& operator=(const blob& other)
+    {
+        if (this != &other)
+            assign(other.data(), other.size());
+
+        return *this;
+    }
+
+    blob& operator=(blob&& other) noexcept(block_traits::propagate_on_container_move_assignment::value
+        || block_traits::is_always_equal::value)
+    {
+        if (this == &other)
+            return *this;
+
+        if constexpr (!block_traits::propagate_on_container_move_assignment::value)
+        {
+            // memory of an unequal allocator cannot be taken over
+            if (!(allocator == other.allocator))
+            {
+                assign(other.data(), other.size());
+
+                return *this;
+            }
+        }
+
+        deallocate();
+
+        if constexpr (block_traits::propagate_on_container_move_assignment::value)
+            allocator = std::move(other.allocator);
+
+        storage = std::exchange(other.storage, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        capacity_ = std::exchange(other.capacity_, 0);
+
+        return *this;
+    }
+
+    allocator_type get_allocator() const
+    {
+        return allocator_type(allocator);
+    }
+
+    unsigned char* data() noexcept
+    {
+        return storage ? storage->bytes : nullptr;
+    }
+
+    const unsigned char* data() const noexcept
+    {
+        return storage ? storage->bytes : nullptr;
+    }
+
+    size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    size_t capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    /**
+     * @brief the largest size whose blocks can be counted without overflow
+     */
+    static constexpr size_t max_size() noexcept
+    {
+        return SIZE_MAX - _Alignment + 1;
+    }
+
+    bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    void reserve(const size_t new_capacity)
+    {
+        if (new_capacity > capacity_)
+            reallocate(new_capacity, true);
+    }
+
+    /**
+     * @brief the contents are kept, new bytes are not initialized
+     */
+    void resize(const size_t new_size)
+    {
+        reserve(new_size);
+        size_ = new_size;
+    }
+
+    void clear() noexcept
+    {
+        size_ = 0;
+    }
+
+    void assign(const void* const value, const size_t length)
+    {
+        if (length > capacity_)
+            reallocate(length, false);
+
+        if (length > 0)
+            std::memcpy(data(), value, length);
+
+        size_ = length;
+    }
+
+    virtual footprint get_footprint() const override
+    {
+        return storage ? footprint{ 1, capacity_ } : footprint{};
+    }
+
+    virtual void describe_layout(xxh64& hash) const override
+    {
+        describe(hash, layout_tag::BLOB);
+    }
+
+    virtual bool serialize(
+        char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const override
+    {
+        if (!write(static_cast<const void*>(&size_), sizeof(size_t), buffer, buffer_size, buffer_offset))
+            return false;
+
+        return write(static_cast<const void*>(data()), size_, buffer, buffer_size, buffer_offset);
+    }
+
+    virtual bool gather(iovec_list& list) const override
+    {
+        list.copy(static_cast<const void*>(&size_), sizeof(size_t));
+        list.append(static_cast<const void*>(data()), size_);
+
+        return true;
+    }
+
+    virtual bool deserialize(
+        const char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const override
+    {
+        size_t length;
+
+        if (!read(static_cast<void*>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
+            return false;
+
+        if (!check_length(length, sizeof(unsigned char), buffer_size, buffer_offset))
+            return false;
+
+        auto& self = const_cast<blob&>(*this);
+
+        if (!self.prepare(length))
+            return false;
+
+        return read(static_cast<void*>(self.data()), length, buffer, buffer_size, buffer_offset);
+    }
+
+    /**
+     * @brief the length and the payload, which is not copied
+     */
+    virtual std::unique_ptr<part_cursor> encode_parts() const override
+    {
+        return make_cursor([this](const size_t index, value_part& part)
+        {
+            if (index > 1)
+                return part_cursor::step::END;
+
+            part = index == 0 ? bytes_part(&size_, sizeof(size_t)) : bytes_part(data(), size_);
+
+            return part_cursor::step::PART;
+        });
+    }
+
+    /**
+     * @brief the payload is read straight into the buffer in slices, see payload_slice()
+     */
+    virtual std::unique_ptr<part_cursor> decode_parts() const override
+    {
+        return make_cursor([this, length = size_t(0), received = size_t(0)](const size_t index, value_part& part) mutable
+        {
+            using step = part_cursor::step;
+
+            auto& self = const_cast<blob&>(*this);
+
+            if (index == 0)
+            {
+                part = bytes_part(&length, sizeof(size_t));
+                return step::PART;
+            }
+
+            if (index == 1)
+            {
+                if (length > max_size() || (length > capacity_ && !limits_scope::allocate(length, sizeof(unsigned char))))
+                    return step::INVALID;
+
+                self.clear();
+            }
+
+            if (received == length)
+                return step::END;
+
+            const size_t slice = payload_slice(length, received);
+
+            self.resize(received + slice);
+            part = bytes_part(self.data() + received, slice);
+            received += slice;
+
+            return step::PART;
+        });
+    }
+
+private:
+    static size_t blocks(const size_t length) noexcept
+    {
+        return (length + _Alignment - 1) / _Alignment;
+    }
+
+    /**
+     * @brief makes room for an incoming value, the old contents are dropped
+     */
+    bool prepare(const size_t length)
+    {
+        if (length > max_size())
+            return false;
+
+        if (length > capacity_)
+        {
+            if (!limits_scope::allocate(length, sizeof(unsigned char)))
+                return false;
+
+            reallocate(length, false);
+        }
+
+        size_ = length;
+
+        return true;
+    }
+
+    void reallocate(const size_t new_capacity, const bool keep)
+    {
+        if (new_capacity > max_size())
+            throw std::length_error("srlz::blob");
+
+        const size_t count = blocks(new_capacity);
+        block* const new_storage = block_traits::allocate(allocator, count);
+
+        if (keep && size_ > 0)
+            std::memcpy(new_storage->bytes, data(), size_);
+
+        deallocate();
+        storage = new_storage;
+        capacity_ = count * _Alignment;
+    }
+
+    void deallocate() noexcept
+    {
+        if (storage)
+            block_traits::deallocate(allocator, storage, capacity_ / _Alignment);
+
+        storage = nullptr;
+        capacity_ = 0;
+    }
+
+    block_allocator allocator;
+    block* storage = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
+
+} // namespace srlz
+
+#endif // SRLZ_BLOB_HPP
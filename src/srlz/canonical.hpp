@@ -0,0 +1,116 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_CANONICAL_HPP
+#define SRLZ_CANONICAL_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "iovec_list.hpp"
+#include "member_type.h"
+#include "xxhash.hpp"
+
+namespace srlz
+{
+
+class base;
+
+/**
+ * @brief while it lives, serialization on this thread writes equal entities as identical bytes:
+ * floating point zeros are positive, NaNs are one quiet NaN, long double padding is zero,
+ * unordered maps are sorted by key and absent values in columns are zero,
+ * serialize() and gather() of the scope hash in a second pass over the output of a successful attempt,
+ * the bytes are still in cache by then and a failed attempt never reaches the digest
+ */
+class canonical_scope final
+{
+public:
+    explicit canonical_scope(const bool hashing = true, const uint64_t seed = 0) noexcept
+        : hashing(hashing), hash(seed), previous(std::exchange(current, this))
+    {
+    }
+
+    ~canonical_scope()
+    {
+        current = previous;
+    }
+
+    canonical_scope(const canonical_scope&) = delete;
+    canonical_scope& operator=(const canonical_scope&) = delete;
+
+    static canonical_scope* get() noexcept
+    {
+        return current;
+    }
+
+    /**
+     * @brief XXH64 of everything serialized by serialize() and gather() of the scope so far
+     */
+    uint64_t digest() const noexcept
+    {
+        return hash.digest();
+    }
+
+    /**
+     * @brief serializes entity, then hashes the bytes it wrote, a failed attempt leaves the digest as it was
+     */
+    bool serialize(const base& entity, char* const buffer, const size_t buffer_size, size_t& buffer_offset);
+
+    /**
+     * @brief gathers entity, then hashes the segments it appended, a failed attempt leaves the digest as it was
+     */
+    bool gather(const base& entity, iovec_list& list);
+
+    /**
+     * @brief the canonical bytes of a fundamental value, either value itself or temporary
+     */
+    static const void* normalize(const member_type type, const void* const value, unsigned char (&temporary)[sizeof(long double)]) noexcept
+    {
+        switch (type)
+        {
+        case member_type::FLOAT       : return normalize_floating<float>(value, temporary);
+        case member_type::DOUBLE      : return normalize_floating<double>(value, temporary);
+        case member_type::LONG_DOUBLE : return normalize_floating<long double>(value, temporary);
+        default                       : return value;
+        }
+    }
+
+private:
+    template<typename T>
+    static const void* normalize_floating(const void* const value, unsigned char (&temporary)[sizeof(long double)]) noexcept
+    {
+        T number;
+        std::memcpy(static_cast<void*>(&number), value, sizeof(T));
+
+        if (number != number)
+            number = std::numeric_limits<T>::quiet_NaN();
+        else if (number == 0)
+            number = 0;
+
+        std::memset(temporary, 0, sizeof(temporary));
+        std::memcpy(temporary, static_cast<const void*>(&number), sizeof(T));
+
+        // the x87 extended format uses 10 of its bytes, the rest is padding
+        if constexpr (std::numeric_limits<T>::digits == 64 && sizeof(T) > 10)
+            std::memset(temporary + 10, 0, sizeof(T) - 10);
+
+        return temporary;
+    }
+
+    static inline thread_local canonical_scope* current = nullptr;
+
+    const bool hashing;
+    xxh64 hash;
+    canonical_scope* const previous;
+};
+
+} // namespace srlz
+
+#endif // SRLZ_CANONICAL_HPP
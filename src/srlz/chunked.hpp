@@ -0,0 +1,320 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_CHUNKED_HPP
+#define SRLZ_CHUNKED_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "coroutine.hpp"
+#include "serializable.hpp"
+
+#ifdef SRLZ_COROUTINES
+
+namespace srlz
+{
+
+/**
+ * @brief lazily yields the serialized bytes, a segment is valid until the generator is resumed,
+ * a segment with a null base means the value could not be encoded, the members of an entity and the parts of a srlz type
+ * are yielded one by one, so a container is yielded element by element and a payload is not copied,
+ * a cached entity, an entity which overrides serialize and a type without parts, such as a custom base type, are gathered first
+ */
+inline generator<iovec_list::segment> encode(const base& value)
+{
+    const auto* const entity = dynamic_cast<const serializable*>(&value);
+    canonical_scope* const canonical = canonical_scope::get();
+    unsigned char temporary[sizeof(long double)];
+
+    if (entity && !entity->is_cache_enabled() && !entity->overrides_serialize())
+    {
+        for (size_t i = 0; i < entity->get_member_count(); ++i)
+        {
+            const auto member = entity->get_member(i);
+
+            co_yield iovec_list::segment{ static_cast<const void*>(member.has_value), sizeof(bool) };
+
+            if (!*member.has_value)
+                continue;
+
+            if (member.type == member_type::SRLZ)
+            {
+                for (auto& segment : encode(*static_cast<const base*>(member.value)))
+                    co_yield segment;
+
+                continue;
+            }
+
+            const size_t size = fundamental_size(member.type);
+
+            if (size == 0)
+            {
+                co_yield iovec_list::segment{ nullptr, 0 };
+                co_return;
+            }
+
+            co_yield iovec_list::segment{ canonical ? canonical_scope::normalize(member.type, member.value, temporary) : member.value, size };
+        }
+
+        co_return;
+    }
+
+    if (auto parts = entity ? nullptr : value.encode_parts())
+    {
+        value_part part;
+        part_cursor::step step;
+
+        while ((step = parts->next(part)) == part_cursor::step::PART)
+        {
+            if (part.value)
+            {
+                for (auto& segment : encode(*part.value))
+                    co_yield segment;
+
+                continue;
+            }
+
+            if (part.length == 0)
+                continue;
+
+            const bool floating = part.type == member_type::FLOAT || part.type == member_type::DOUBLE || part.type == member_type::LONG_DOUBLE;
+
+            if (!canonical || !floating)
+            {
+                co_yield iovec_list::segment{ static_cast<const void*>(part.data), part.length };
+                continue;
+            }
+
+            // a canonical scope normalizes floating values one at a time
+            const size_t size = fundamental_size(part.type);
+
+            for (size_t offset = 0; offset < part.length; offset += size)
+                co_yield iovec_list::segment{ canonical_scope::normalize(part.type, static_cast<const char*>(part.data) + offset, temporary), size };
+        }
+
+        if (step == part_cursor::step::INVALID)
+            co_yield iovec_list::segment{ nullptr, 0 };
+
+        co_return;
+    }
+
+    iovec_list list;
+
+    if (!value.gather(list))
+    {
+        co_yield iovec_list::segment{ nullptr, 0 };
+        co_return;
+    }
+
+    for (auto& segment : list.get_segments())
+        co_yield segment;
+}
+
+/**
+ * @brief deserializes the bytes fed to reader and suspends while they run out, the members of an entity and the parts
+ * of a srlz type are read one by one, reading as many bytes as the lengths already read ask for,
+ * an entity which overrides serialize and a type without parts, such as a custom base type, are accumulated until deserialize succeeds
+ */
+inline task decode(const base& value, chunk_reader& reader)
+{
+    const auto* const entity = dynamic_cast<const serializable*>(&value);
+
+    if (entity && !entity->overrides_serialize())
+    {
+        entity->invalidate();
+
+        for (size_t i = 0; i < entity->get_member_count(); ++i)
+        {
+            const auto member = entity->get_member(i);
+
+            if (!co_await reader.read(static_cast<void*>(member.has_value), sizeof(bool)))
+                co_return false;
+
+            if (!*member.has_value)
+                continue;
+
+            if (member.type == member_type::SRLZ)
+            {
+                if (!co_await decode(*static_cast<const base*>(member.value), reader))
+                    co_return false;
+
+                continue;
+            }
+
+            const size_t size = fundamental_size(member.type);
+
+            if (size == 0)
+                co_return false;
+
+            if (!co_await reader.read(member.value, size))
+                co_return false;
+        }
+
+        // has_value of a record of a mapped_store is written to the file
+        entity->invalidate();
+
+        co_return true;
+    }
+
+    if (auto parts = entity ? nullptr : value.decode_parts())
+    {
+        value_part part;
+        part_cursor::step step;
+
+        while ((step = parts->next(part)) == part_cursor::step::PART)
+        {
+            if (part.value)
+            {
+                if (!co_await decode(*part.value, reader))
+                    co_return false;
+
+                continue;
+            }
+
+            if (part.length == 0)
+                continue;
+
+            if (!co_await reader.read(part.data, part.length))
+                co_return false;
+        }
+
+        co_return step == part_cursor::step::END;
+    }
+
+    std::vector<char> accumulated;
+    const size_t checkpoint = dictionary_scope::checkpoint();
+
+    while (co_await reader.read_some(accumulated))
+    {
+        size_t offset = 0;
+
+        if (value.deserialize(accumulated.data(), accumulated.size(), offset))
+        {
+            reader.put_back(accumulated.size() - offset);
+            co_return true;
+        }
+
+        dictionary_scope::rollback(checkpoint);
+    }
+
+    co_return false;
+}
+
+/**
+ * @brief yields the serialized entity in chunks of chunk_size bytes, the last one may be shorter,
+ * a chunk is valid until the generator is resumed, a chunk with a null base means the entity could not be encoded,
+ * only one chunk is held in memory, payloads are copied from the entity as the chunks are consumed
+ */
+inline generator<iovec_list::segment> encode_chunks(const base& entity, const size_t chunk_size)
+{
+    std::vector<char> chunk(chunk_size);
+    size_t chunk_offset = 0;
+
+    for (auto& [segment_base, segment_length] : encode(entity))
+    {
+        if (!segment_base && segment_length == 0)
+        {
+            co_yield iovec_list::segment{ nullptr, 0 };
+            co_return;
+        }
+
+        for (size_t offset = 0; offset < segment_length;)
+        {
+            const size_t length = std::min(segment_length - offset, chunk_size - chunk_offset);
+
+            std::memcpy(chunk.data() + chunk_offset, static_cast<const char*>(segment_base) + offset, length);
+            chunk_offset += length;
+            offset += length;
+
+            if (chunk_offset == chunk_size)
+            {
+                co_yield iovec_list::segment{ static_cast<const void*>(chunk.data()), chunk_size };
+                chunk_offset = 0;
+            }
+        }
+    }
+
+    if (chunk_offset > 0)
+        co_yield iovec_list::segment{ static_cast<const void*>(chunk.data()), chunk_offset };
+}
+
+/**
+ * @brief deserializes an entity from chunks as they arrive, the entity has to outlive the decoder
+ */
+class decoder final
+{
+public:
+    explicit decoder(const base& entity)
+        : decoding(decode(entity, reader)) {}
+
+    /**
+     * @brief true once the entity is complete, bytes after its end stay unconsumed, see remaining()
+     */
+    bool feed(const char* const data, const size_t size)
+    {
+        if (decoding.done())
+            return true;
+
+        reader.feed(data, size);
+
+        if (!started)
+        {
+            started = true;
+            decoding.resume();
+        }
+
+        return decoding.done();
+    }
+
+    /**
+     * @brief signals the end of the input, false if the entity is incomplete or invalid
+     */
+    bool finish()
+    {
+        if (!started)
+        {
+            started = true;
+            reader.finish();
+            decoding.resume();
+        }
+        else if (!decoding.done())
+            reader.finish();
+
+        return success();
+    }
+
+    bool done() const noexcept
+    {
+        return decoding.done();
+    }
+
+    bool success() const
+    {
+        return decoding.done() && decoding.result();
+    }
+
+    /**
+     * @brief bytes of the last chunk which were not consumed
+     */
+    size_t remaining() const noexcept
+    {
+        return reader.available();
+    }
+
+private:
+    chunk_reader reader;
+    task decoding;
+    bool started = false;
+};
+
+} // namespace srlz
+
+#endif // SRLZ_COROUTINES
+
+#endif // SRLZ_CHUNKED_HPP
@@ -0,0 +1,352 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_COLUMNAR_HPP
+#define SRLZ_COLUMNAR_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "base.hpp"
+#include "serializable.hpp"
+
+namespace srlz
+{
+
+/**
+ * @brief values of one member of a serialized batch, read in place,
+ * data() is null if the column is not aligned for T in memory, operator[] works either way
+ */
+template<typename T>
+class column_view
+{
+public:
+    column_view() = default;
+
+    column_view(const uint8_t* const presence, const char* const values, const size_t count) noexcept
+        : presence(presence), values(values), count(count)
+    {
+    }
+
+    size_t size() const noexcept
+    {
+        return count;
+    }
+
+    bool empty() const noexcept
+    {
+        return count == 0;
+    }
+
+    bool has_value(const size_t index) const noexcept
+    {
+        return (presence[index >> 3] >> (index & 7)) & 1;
+    }
+
+    T operator[](const size_t index) const noexcept
+    {
+        T value;
+        std::memcpy(static_cast<void*>(&value), values + index * sizeof(T), sizeof(T));
+
+        return value;
+    }
+
+    const T* data() const noexcept
+    {
+        return reinterpret_cast<uintptr_t>(values) % alignof(T) == 0 ? reinterpret_cast<const T*>(values) : nullptr;
+    }
+
+    /**
+     * @brief one bit per element, the lowest bit of the first byte is the first element
+     */
+    const uint8_t* get_presence() const noexcept
+    {
+        return presence;
+    }
+
+    /**
+     * @brief the values as bytes, not necessarily aligned
+     */
+    const char* get_values() const noexcept
+    {
+        return values;
+    }
+
+private:
+    const uint8_t* presence = nullptr;
+    const char* values = nullptr;
+    size_t count = 0;
+};
+
+/**
+ * @brief batch of flat entities, which have fundamental members only, written column by column:
+ * the count, then for every member a presence bitmap, the number of padding bytes, the padding and all the values,
+ * columns are aligned to their type relative to the start of the buffer,
+ * absent values are written as they are or as zeros in a canonical_scope,
+ * it has no parts to stream since the padding depends on the offset in the buffer, so chunked.hpp gathers it
+ */
+template<typename _Tp>
+class columnar final : public base, public std::vector<std::unique_ptr<_Tp>>
+{
+    static_assert(std::is_base_of_v<serializable, _Tp>);
+
+public:
+    using container_type = std::vector<std::unique_ptr<_Tp>>;
+
+    /**
+     * @brief a serialized batch parsed in place, valid while the buffer lives
+     */
+    class view
+    {
+    public:
+        size_t size() const noexcept
+        {
+            return count;
+        }
+
+        size_t get_member_count() const noexcept
+        {
+            return columns.size();
+        }
+
+        /**
+         * @brief an empty view if the member does not exist or is not of type T
+         */
+        template<typename T>
+        column_view<T> column(const size_t member_index) const noexcept
+        {
+            if (member_index >= columns.size() || columns[member_index].size != sizeof(T))
+                return {};
+
+            return column_view<T>(columns[member_index].presence, columns[member_index].values, count);
+        }
+
+        /**
+         * @brief deserializes one element of the batch, e.g. a match of a scan
+         */
+        void extract(const size_t index, const _Tp& item) const noexcept
+        {
+            item.invalidate();
+
+            for (size_t m = 0; m < columns.size(); ++m)
+            {
+                const auto& column = columns[m];
+                const auto member = item.get_member(m);
+
+                *member.has_value = (column.presence[index >> 3] >> (index & 7)) & 1;
+                std::memcpy(member.value, column.values + index * column.size, column.size);
+            }
+        }
+
+    private:
+        friend class columnar;
+
+        struct column_data
+        {
+            size_t size;
+            const uint8_t* presence;
+            const char* values;
+        };
+
+        size_t count = 0;
+        std::vector<column_data> columns;
+    };
+
+    virtual ~columnar() = default;
+    columnar() = default;
+    columnar(columnar&&) = default;
+    columnar& operator=(columnar&&) = default;
+
+    /**
+     * @brief the pointer array and every element
+     */
+    virtual footprint get_footprint() const override
+    {
+        const container_type& self = *this;
+        footprint result;
+
+        if (self.capacity() > 0)
+            result += { 1, self.capacity() * sizeof(std::unique_ptr<_Tp>) };
+
+        for (auto& item : self)
+            result += footprint{ 1, sizeof(_Tp) } + item->get_footprint();
+
+        return result;
+    }
+
+    virtual void describe_layout(xxh64& hash) const override
+    {
+        describe(hash, layout_tag::COLUMNAR);
+        describe_item<_Tp>(hash);
+    }
+
+    virtual void link_entities(const serializable* const parent) const override
+    {
+        for (auto& item : static_cast<const container_type&>(*this))
+            item->link_entities(parent);
+    }
+
+    virtual bool serialize(
+        char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const override
+    {
+        const container_type& self = *this;
+        const size_t length = self.size();
+
+        if (!write(static_cast<const void*>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
+            return false;
+
+        if (length == 0)
+            return true;
+
+        const size_t member_count = self.front()->get_member_count();
+        canonical_scope* const canonical = canonical_scope::get();
+        unsigned char temporary[sizeof(long double)];
+
+        for (size_t m = 0; m < member_count; ++m)
+        {
+            const size_t size = fundamental_size(self.front()->get_member(m).type);
+
+            if (size == 0)
+                return false;
+
+            const size_t bitmap_size = (length + 7) / 8;
+            const uint8_t padding = padding_of(buffer_offset + bitmap_size + sizeof(uint8_t), size);
+
+            if (buffer_offset > buffer_size
+                || bitmap_size + sizeof(uint8_t) + padding > buffer_size - buffer_offset
+                || length > (buffer_size - buffer_offset - bitmap_size - sizeof(uint8_t) - padding) / size)
+                return false;
+
+            uint8_t* const bitmap = reinterpret_cast<uint8_t*>(buffer + buffer_offset);
+            std::memset(bitmap, 0, bitmap_size + sizeof(uint8_t) + padding);
+            bitmap[bitmap_size] = padding;
+            buffer_offset += bitmap_size + sizeof(uint8_t) + padding;
+
+            char* values = buffer + buffer_offset;
+
+            for (size_t i = 0; i < length; ++i, values += size)
+            {
+                const auto item = self[i]->get_member(m);
+
+                bitmap[i >> 3] |= uint8_t(*item.has_value) << (i & 7);
+
+                if (!canonical)
+                    std::memcpy(values, item.value, size);
+                else if (*item.has_value)
+                    std::memcpy(values, canonical_scope::normalize(item.type, item.value, temporary), size);
+                else
+                    std::memset(values, 0, size);
+            }
+
+            buffer_offset += length * size;
+        }
+
+        return true;
+    }
+
+    virtual bool deserialize(
+        const char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const override
+    {
+        view parsed;
+
+        if (!parse(buffer, buffer_size, buffer_offset, parsed))
+            return false;
+
+        auto& self = *((container_type*)this);
+
+        // elements of the previous batch are reused
+        if (self.size() > parsed.count)
+            self.resize(parsed.count);
+
+        while (self.size() < parsed.count)
+        {
+            self.push_back(std::make_unique<_Tp>());
+            plan_item(*self.back());
+        }
+
+        for (size_t i = 0; i < parsed.count; ++i)
+            parsed.extract(i, *self[i]);
+
+        return true;
+    }
+
+    /**
+     * @brief parses a serialized batch without deserializing it, the columns can then be read in place
+     */
+    static bool parse(
+        const char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset,
+        view& parsed
+        )
+    {
+        size_t length;
+
+        if (buffer_offset > buffer_size || sizeof(size_t) > buffer_size - buffer_offset)
+            return false;
+
+        std::memcpy(static_cast<void*>(&length), buffer + buffer_offset, sizeof(size_t));
+        buffer_offset += sizeof(size_t);
+
+        // every element takes at least one bit of every bitmap
+        if (length / 8 > buffer_size - buffer_offset || !limits_scope::allocate(length, sizeof(_Tp)))
+            return false;
+
+        parsed.count = length;
+        parsed.columns.clear();
+
+        if (length == 0)
+            return true;
+
+        const _Tp prototype;
+        const size_t member_count = prototype.get_member_count();
+        const size_t bitmap_size = (length + 7) / 8;
+
+        for (size_t m = 0; m < member_count; ++m)
+        {
+            const size_t size = fundamental_size(prototype.get_member(m).type);
+
+            if (size == 0 || bitmap_size + sizeof(uint8_t) > buffer_size - buffer_offset)
+                return false;
+
+            const uint8_t* const bitmap = reinterpret_cast<const uint8_t*>(buffer + buffer_offset);
+            const uint8_t padding = bitmap[bitmap_size];
+            buffer_offset += bitmap_size + sizeof(uint8_t);
+
+            if (padding > buffer_size - buffer_offset)
+                return false;
+
+            buffer_offset += padding;
+
+            if (length > (buffer_size - buffer_offset) / size)
+                return false;
+
+            parsed.columns.push_back({ size, bitmap, buffer + buffer_offset });
+            buffer_offset += length * size;
+        }
+
+        return true;
+    }
+
+private:
+    static uint8_t padding_of(const size_t offset, const size_t alignment) noexcept
+    {
+        return uint8_t((alignment - offset % alignment) % alignment);
+    }
+};
+
+} // namespace srlz
+
+#endif // SRLZ_COLUMNAR_HPP
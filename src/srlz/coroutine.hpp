@@ -0,0 +1,446 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_COROUTINE_HPP
+#define SRLZ_COROUTINE_HPP
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define SRLZ_COROUTINES
+#endif
+
+#ifdef SRLZ_COROUTINES
+
+#include <coroutine>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace srlz
+{
+
+/**
+ * @brief lazy synchronous sequence, a yielded value is valid until the generator is resumed
+ */
+template<typename T>
+class generator final
+{
+public:
+    struct promise_type
+    {
+        const T* value = nullptr;
+
+        generator get_return_object() noexcept
+        {
+            return generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        std::suspend_always yield_value(const T& yielded) noexcept
+        {
+            value = std::addressof(yielded);
+
+            return {};
+        }
+
+        void return_void() noexcept {}
+        void unhandled_exception() { throw; }
+    };
+
+    struct sentinel {};
+
+    class iterator
+    {
+    public:
+        explicit iterator(std::coroutine_handle<promise_type> handle) noexcept : handle(handle) {}
+
+        const T& operator*() const noexcept
+        {
+            return *handle.promise().value;
+        }
+
+        iterator& operator++()
+        {
+            handle.resume();
+
+            return *this;
+        }
+
+        bool operator==(sentinel) const noexcept
+        {
+            return handle.done();
+        }
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    generator(generator&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    generator(const generator&) = delete;
+
+    ~generator()
+    {
+        if (handle)
+            handle.destroy();
+    }
+
+    iterator begin()
+    {
+        handle.resume();
+
+        return iterator(handle);
+    }
+
+    sentinel end() const noexcept
+    {
+        return {};
+    }
+
+private:
+    explicit generator(std::coroutine_handle<promise_type> handle) noexcept : handle(handle) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/**
+ * @brief lazily started coroutine with a bool result, awaiting it starts it
+ * and resumes the awaiting coroutine on completion
+ */
+class task final
+{
+public:
+    struct promise_type
+    {
+        bool result = false;
+        std::exception_ptr exception;
+        std::coroutine_handle<> continuation;
+
+        task get_return_object() noexcept
+        {
+            return task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        auto final_suspend() noexcept
+        {
+            struct final_awaiter
+            {
+                bool await_ready() const noexcept { return false; }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) const noexcept
+                {
+                    if (handle.promise().continuation)
+                        return handle.promise().continuation;
+
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            return final_awaiter{};
+        }
+
+        void return_value(const bool value) noexcept
+        {
+            result = value;
+        }
+
+        void unhandled_exception() noexcept
+        {
+            exception = std::current_exception();
+        }
+    };
+
+    task(task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    task(const task&) = delete;
+
+    ~task()
+    {
+        if (handle)
+            handle.destroy();
+    }
+
+    auto operator co_await() noexcept
+    {
+        struct awaiter
+        {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept { return false; }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) const noexcept
+            {
+                handle.promise().continuation = awaiting;
+
+                return handle;
+            }
+
+            bool await_resume() const
+            {
+                if (handle.promise().exception)
+                    std::rethrow_exception(handle.promise().exception);
+
+                return handle.promise().result;
+            }
+        };
+
+        return awaiter{ handle };
+    }
+
+    /**
+     * @brief starts or continues a task nobody awaits
+     */
+    void resume()
+    {
+        handle.resume();
+    }
+
+    bool done() const noexcept
+    {
+        return handle.done();
+    }
+
+    /**
+     * @brief the result of a done task
+     */
+    bool result() const
+    {
+        if (handle.promise().exception)
+            std::rethrow_exception(handle.promise().exception);
+
+        return handle.promise().result;
+    }
+
+private:
+    explicit task(std::coroutine_handle<promise_type> handle) noexcept : handle(handle) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/**
+ * @brief input of a decoding coroutine, reads suspend the decoder until enough bytes are fed
+ */
+class chunk_reader final
+{
+public:
+    auto read(void* const value, const size_t value_length) noexcept
+    {
+        struct awaiter
+        {
+            chunk_reader& reader;
+            char* value;
+            size_t value_length;
+            bool ready = false;
+
+            bool await_ready() noexcept
+            {
+                ready = reader.take(value, value_length) || reader.finished;
+
+                return ready;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) noexcept
+            {
+                reader.pending = value;
+                reader.pending_length = value_length;
+                reader.waiting = handle;
+            }
+
+            bool await_resume() const noexcept
+            {
+                if (ready)
+                    return value_length == 0;
+
+                return reader.pending_length == 0;
+            }
+        };
+
+        return awaiter{ *this, static_cast<char*>(value), value_length };
+    }
+
+    /**
+     * @brief appends at least one byte to value, false if the input has finished
+     */
+    auto read_some(std::vector<char>& value) noexcept
+    {
+        struct awaiter
+        {
+            chunk_reader& reader;
+            std::vector<char>& value;
+            bool ready = false;
+            bool result = false;
+
+            bool await_ready()
+            {
+                result = reader.take_some(value);
+                ready = result || reader.finished;
+
+                return ready;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) noexcept
+            {
+                reader.pending_some = &value;
+                reader.waiting = handle;
+            }
+
+            bool await_resume() noexcept
+            {
+                if (ready)
+                    return result;
+
+                return std::exchange(reader.pending_some, nullptr) == nullptr;
+            }
+        };
+
+        return awaiter{ *this, value };
+    }
+
+    /**
+     * @brief returns the last length bytes taken from the current input
+     */
+    void put_back(const size_t length) noexcept
+    {
+        input_offset -= length;
+    }
+
+    size_t available() const noexcept
+    {
+        return input_size - input_offset;
+    }
+
+    /**
+     * @brief the input has to stay valid until it is consumed or the next feed
+     */
+    void feed(const char* const data, const size_t size)
+    {
+        input = data;
+        input_size = size;
+        input_offset = 0;
+
+        if (!waiting)
+            return;
+
+        if (pending_some)
+        {
+            if (!take_some(*pending_some))
+                return;
+
+            pending_some = nullptr;
+        }
+        else if (!take(pending, pending_length))
+            return;
+
+        std::exchange(waiting, nullptr).resume();
+    }
+
+    void finish()
+    {
+        finished = true;
+
+        if (waiting)
+            std::exchange(waiting, nullptr).resume();
+    }
+
+private:
+    bool take(char*& value, size_t& value_length) noexcept
+    {
+        const size_t length = value_length < available() ? value_length : available();
+
+        std::memcpy(value, input + input_offset, length);
+        input_offset += length;
+        value += length;
+        value_length -= length;
+
+        return value_length == 0;
+    }
+
+    bool take_some(std::vector<char>& value)
+    {
+        if (available() == 0)
+            return false;
+
+        value.insert(value.end(), input + input_offset, input + input_size);
+        input_offset = input_size;
+
+        return true;
+    }
+
+    const char* input = nullptr;
+    size_t input_size = 0;
+    size_t input_offset = 0;
+    char* pending = nullptr;
+    size_t pending_length = 0;
+    std::vector<char>* pending_some = nullptr;
+    std::coroutine_handle<> waiting;
+    bool finished = false;
+};
+
+/**
+ * @brief single threaded executor, runs spawned tasks and tasks which yield with co_await schedule()
+ * in FIFO order until all of them are done
+ */
+class executor final
+{
+public:
+    auto schedule() noexcept
+    {
+        struct awaiter
+        {
+            executor& owner;
+
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                owner.ready.push_back(handle);
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        return awaiter{ *this };
+    }
+
+    void spawn(task&& spawned)
+    {
+        tasks.push_back(std::move(spawned));
+        ready.push_back(nullptr);
+    }
+
+    void run()
+    {
+        size_t started = 0;
+
+        while (!ready.empty())
+        {
+            auto handle = ready.front();
+            ready.pop_front();
+
+            if (handle)
+                handle.resume();
+            else
+                tasks[started++].resume();
+        }
+    }
+
+private:
+    std::deque<task> tasks;
+    std::deque<std::coroutine_handle<>> ready;
+};
+
+} // namespace srlz
+
+#endif // SRLZ_COROUTINES
+
+#endif // SRLZ_COROUTINE_HPP
@@ -0,0 +1,142 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_DICTIONARY_HPP
+#define SRLZ_DICTIONARY_HPP
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace srlz
+{
+
+/**
+ * @brief string dictionary of one batch, while it lives strings on this thread are written once
+ * and then referenced by index, the writer and the reader open a scope with the same limits around the batch,
+ * a failed attempt leaves entries the other side never sees, so a caller which retries rolls back to a checkpoint(),
+ * only the wire size shrinks: the reader keeps its own copy of every literal to resolve later references
+ * and a reference is copied into its string, decoded strings never share storage with the dictionary
+ */
+class dictionary_scope final
+{
+public:
+    /**
+     * @brief a header with the low bit set references an entry, otherwise it is the length of a literal shifted left,
+     * extended_length is followed by the length as size_t
+     */
+    static constexpr uint32_t extended_length = UINT32_MAX - 1;
+
+    explicit dictionary_scope(const size_t max_entries = 1 << 16, const size_t max_length = 256)
+        : max_entries(max_entries < (size_t(1) << 31) ? max_entries : (size_t(1) << 31)),
+        max_length(max_length),
+        previous(std::exchange(current, this))
+    {
+    }
+
+    ~dictionary_scope()
+    {
+        current = previous;
+    }
+
+    dictionary_scope(const dictionary_scope&) = delete;
+    dictionary_scope& operator=(const dictionary_scope&) = delete;
+
+    /**
+     * @brief the innermost scope of this thread or nullptr
+     */
+    static dictionary_scope* get() noexcept
+    {
+        return current;
+    }
+
+    size_t size() const noexcept
+    {
+        return entries.size();
+    }
+
+    /**
+     * @brief the size of the dictionary of this thread before an attempt which may fail, 0 without a scope
+     */
+    static size_t checkpoint() noexcept
+    {
+        return current ? current->entries.size() : 0;
+    }
+
+    /**
+     * @brief drops the entries added to the dictionary of this thread since checkpoint
+     */
+    static void rollback(const size_t checkpoint)
+    {
+        if (!current)
+            return;
+
+        while (current->entries.size() > checkpoint)
+        {
+            current->index.erase(current->entries.back());
+            current->entries.pop_back();
+        }
+    }
+
+    /**
+     * @brief the header of value for the writer, a new value is added to the dictionary
+     */
+    uint32_t header(const std::string_view value)
+    {
+        if (auto it = index.find(value); it != index.end())
+            return (it->second << 1) | 1;
+
+        if (internable(value))
+        {
+            entries.emplace_back(value);
+            index.emplace(entries.back(), uint32_t(entries.size() - 1));
+        }
+
+        return value.size() < extended_length / 2 ? uint32_t(value.size() << 1) : extended_length;
+    }
+
+    /**
+     * @brief the entry referenced by a header for the reader or nullptr if it is unknown
+     */
+    const std::string* find(const uint32_t header) const noexcept
+    {
+        const size_t position = header >> 1;
+
+        return position < entries.size() ? &entries[position] : nullptr;
+    }
+
+    /**
+     * @brief a literal read by the reader, copied under the same rule as by the writer,
+     * the string it was read into may change before a later reference to it arrives
+     */
+    void add(const std::string_view value)
+    {
+        if (internable(value))
+            entries.emplace_back(value);
+    }
+
+private:
+    bool internable(const std::string_view value) const noexcept
+    {
+        return value.size() <= max_length && entries.size() < max_entries;
+    }
+
+    static inline thread_local dictionary_scope* current = nullptr;
+
+    const size_t max_entries;
+    const size_t max_length;
+    dictionary_scope* const previous;
+    std::deque<std::string> entries;
+    std::unordered_map<std::string_view, uint32_t> index;
+};
+
+} // namespace srlz
+
+#endif // SRLZ_DICTIONARY_HPP
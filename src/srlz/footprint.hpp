@@ -0,0 +1,51 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_FOOTPRINT_HPP
+#define SRLZ_FOOTPRINT_HPP
+
+#include <cstddef>
+
+namespace srlz
+{
+
+/**
+ * @brief heap memory owned by a value: the number of allocations and the bytes requested by them,
+ * the overhead of the allocator is not included, nodes of standard containers are estimated
+ */
+struct footprint
+{
+    size_t allocations = 0;
+    size_t bytes = 0;
+
+    footprint& operator+=(const footprint& other) noexcept
+    {
+        allocations += other.allocations;
+        bytes += other.bytes;
+
+        return *this;
+    }
+
+    friend footprint operator+(footprint left, const footprint& right) noexcept
+    {
+        return left += right;
+    }
+
+    friend bool operator==(const footprint& left, const footprint& right) noexcept
+    {
+        return left.allocations == right.allocations && left.bytes == right.bytes;
+    }
+
+    friend bool operator!=(const footprint& left, const footprint& right) noexcept
+    {
+        return !(left == right);
+    }
+};
+
+} // namespace srlz
+
+#endif // SRLZ_FOOTPRINT_HPP
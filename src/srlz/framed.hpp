@@ -0,0 +1,238 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_FRAMED_HPP
+#define SRLZ_FRAMED_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+#include "base.hpp"
+#include "dictionary.hpp"
+
+namespace srlz
+{
+
+/**
+ * @brief a serialized record inside a buffer, valid while the buffer lives
+ */
+struct record_view
+{
+    const char* data = nullptr;
+    size_t size = 0;
+
+    /**
+     * @brief false if the record is invalid or does not fill the view
+     */
+    bool deserialize(const base& entity) const
+    {
+        size_t offset = 0;
+
+        return entity.deserialize(data, size, offset) && offset == size;
+    }
+};
+
+/**
+ * @brief appends records to a buffer, each one after a uint32_t length,
+ * buffers written this way can be concatenated and still read as one
+ */
+class framed_writer final
+{
+public:
+    explicit framed_writer(std::vector<char>& output) : output(output) {}
+
+    /**
+     * @brief serializes the record in place after its length, false if it is larger than max_record_size
+     */
+    bool append(const base& record)
+    {
+        const size_t start = output.size();
+        const size_t checkpoint = dictionary_scope::checkpoint();
+        size_t reserve = std::max(last_size * 2, min_reserve);
+
+        while (true)
+        {
+            output.resize(start + sizeof(uint32_t) + reserve);
+
+            size_t offset = start + sizeof(uint32_t);
+
+            if (record.serialize(output.data(), output.size(), offset))
+            {
+                const uint32_t length = uint32_t(offset - start - sizeof(uint32_t));
+                std::memcpy(output.data() + start, &length, sizeof(uint32_t));
+                output.resize(offset);
+                last_size = length;
+
+                return true;
+            }
+
+            dictionary_scope::rollback(checkpoint);
+
+            if (reserve >= max_record_size)
+            {
+                output.resize(start);
+
+                return false;
+            }
+
+            reserve = std::min(reserve * 2, max_record_size);
+        }
+    }
+
+    /**
+     * @brief appends an already serialized record
+     */
+    bool append(const record_view& record)
+    {
+        if (record.size > max_record_size)
+            return false;
+
+        const uint32_t length = uint32_t(record.size);
+        const char* const header = reinterpret_cast<const char*>(&length);
+        output.insert(output.end(), header, header + sizeof(uint32_t));
+        output.insert(output.end(), record.data, record.data + record.size);
+
+        return true;
+    }
+
+    static constexpr size_t max_record_size = size_t(1) << 30;
+
+private:
+    static constexpr size_t min_reserve = 64;
+
+    std::vector<char>& output;
+    size_t last_size = 0;
+};
+
+/**
+ * @brief the records of a framed buffer in place, iteration reads only the lengths,
+ * so skipping a record is O(1) and nothing is allocated, it stops at the end
+ * or at a record which does not fit, see valid_size()
+ */
+class framed_range final
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = record_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const record_view*;
+        using reference = const record_view&;
+
+        iterator() = default;
+
+        reference operator*() const noexcept
+        {
+            return view;
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &view;
+        }
+
+        iterator& operator++() noexcept
+        {
+            read(view.data + view.size);
+
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            iterator previous = *this;
+            ++*this;
+
+            return previous;
+        }
+
+        bool operator==(const iterator& other) const noexcept
+        {
+            return view.data == other.view.data;
+        }
+
+        bool operator!=(const iterator& other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+    private:
+        friend class framed_range;
+
+        iterator(const char* const position, const char* const end) noexcept : end(end)
+        {
+            read(position);
+        }
+
+        void read(const char* const position) noexcept
+        {
+            uint32_t length;
+
+            if (size_t(end - position) < sizeof(uint32_t))
+            {
+                view = {};
+
+                return;
+            }
+
+            std::memcpy(&length, position, sizeof(uint32_t));
+
+            if (length > size_t(end - position) - sizeof(uint32_t))
+            {
+                view = {};
+
+                return;
+            }
+
+            view = { position + sizeof(uint32_t), length };
+        }
+
+        record_view view;
+        const char* end = nullptr;
+    };
+
+    framed_range(const char* const data, const size_t size) noexcept : data(data), size(size) {}
+
+    explicit framed_range(const std::vector<char>& buffer) noexcept : framed_range(buffer.data(), buffer.size()) {}
+
+    iterator begin() const noexcept
+    {
+        return iterator(data, data + size);
+    }
+
+    iterator end() const noexcept
+    {
+        return iterator();
+    }
+
+    /**
+     * @brief bytes taken by whole records from the beginning, the rest is an incomplete record
+     * which a stream has to keep until more data arrives
+     */
+    size_t valid_size() const noexcept
+    {
+        const char* position = data;
+
+        for (const record_view& record : *this)
+            position = record.data + record.size;
+
+        return size_t(position - data);
+    }
+
+private:
+    const char* data;
+    size_t size;
+};
+
+} // namespace srlz
+
+#endif // SRLZ_FRAMED_HPP
@@ -0,0 +1,128 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_IOVEC_LIST_HPP
+#define SRLZ_IOVEC_LIST_HPP
+
+#include <cstring>
+#include <vector>
+
+#ifdef __unix__
+#include <sys/uio.h>
+#endif
+
+namespace srlz
+{
+
+/**
+ * @brief list of byte ranges which together form a serialized message,
+ * small values are coalesced into an owned scratch buffer,
+ * values of at least reference_threshold bytes are referenced in place and have to outlive the list
+ */
+class iovec_list final
+{
+public:
+    struct segment
+    {
+        const void* base;
+        size_t length;
+    };
+
+    explicit iovec_list(const size_t reference_threshold = 256) noexcept
+        : reference_threshold(reference_threshold) {}
+
+    void append(const void* const value, const size_t value_length)
+    {
+        if (value_length >= reference_threshold)
+            reference(value, value_length);
+        else
+            copy(value, value_length);
+    }
+
+    void copy(const void* const value, const size_t value_length)
+    {
+        if (value_length == 0)
+            return;
+
+        if (entries.empty() || entries.back().pointer || entries.back().offset + entries.back().length != scratch.size())
+            entries.push_back({ nullptr, scratch.size(), 0 });
+
+        scratch.insert(scratch.end(), static_cast<const char*>(value), static_cast<const char*>(value) + value_length);
+        entries.back().length += value_length;
+        total_length += value_length;
+    }
+
+    void reference(const void* const value, const size_t value_length)
+    {
+        if (value_length == 0)
+            return;
+
+        entries.push_back({ value, 0, value_length });
+        total_length += value_length;
+    }
+
+    /**
+     * @brief valid until the next append
+     */
+    const std::vector<segment>& get_segments()
+    {
+        segments.clear();
+        segments.reserve(entries.size());
+
+        for (auto& entry : entries)
+            segments.push_back({ entry.pointer ? entry.pointer : scratch.data() + entry.offset, entry.length });
+
+        return segments;
+    }
+
+#ifdef __unix__
+    /**
+     * @brief valid until the next append, ready for writev and sendmsg
+     */
+    std::vector<iovec> get_iovecs()
+    {
+        std::vector<iovec> iovecs;
+        iovecs.reserve(entries.size());
+
+        for (auto& [base, length] : get_segments())
+            iovecs.push_back({ const_cast<void*>(base), length });
+
+        return iovecs;
+    }
+#endif
+
+    size_t size() const noexcept
+    {
+        return total_length;
+    }
+
+    void clear() noexcept
+    {
+        scratch.clear();
+        entries.clear();
+        segments.clear();
+        total_length = 0;
+    }
+
+private:
+    struct entry
+    {
+        const void* pointer;
+        size_t offset;
+        size_t length;
+    };
+
+    const size_t reference_threshold;
+    size_t total_length = 0;
+    std::vector<char> scratch;
+    std::vector<entry> entries;
+    std::vector<segment> segments;
+};
+
+} // namespace srlz
+
+#endif // SRLZ_IOVEC_LIST_HPP
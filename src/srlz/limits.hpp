@@ -0,0 +1,125 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_LIMITS_HPP
+#define SRLZ_LIMITS_HPP
+
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+namespace srlz
+{
+
+struct limits
+{
+    /**
+     * @brief bytes allocated by strings and containers during one scope
+     */
+    size_t max_allocation = std::numeric_limits<size_t>::max();
+
+    /**
+     * @brief length of one string or container
+     */
+    size_t max_elements = std::numeric_limits<size_t>::max();
+
+    /**
+     * @brief nesting of entities
+     */
+    size_t max_depth = std::numeric_limits<size_t>::max();
+};
+
+/**
+ * @brief bounds every deserialization on this thread while it lives, the innermost scope applies,
+ * decoding coroutines check allocation and lengths only since they may outlive the scope,
+ * without a scope the checks cost one thread local load
+ */
+class limits_scope final
+{
+public:
+    explicit limits_scope(const limits& value) noexcept
+        : value(value), previous(std::exchange(current, this))
+    {
+    }
+
+    ~limits_scope()
+    {
+        current = previous;
+    }
+
+    limits_scope(const limits_scope&) = delete;
+    limits_scope& operator=(const limits_scope&) = delete;
+
+    size_t get_allocated() const noexcept
+    {
+        return allocated;
+    }
+
+    /**
+     * @brief accounts for count elements of size bytes, false if a limit is exceeded
+     */
+    static bool allocate(const size_t count, const size_t size) noexcept
+    {
+        limits_scope* const scope = current;
+
+        if (!scope)
+            return true;
+
+        if (count > scope->value.max_elements)
+            return false;
+
+        if (size != 0 && count > (scope->value.max_allocation - scope->allocated) / size)
+            return false;
+
+        scope->allocated += count * size;
+
+        return true;
+    }
+
+    /**
+     * @brief holds one level of nesting, converts to false if it is too deep
+     */
+    class depth_guard final
+    {
+    public:
+        depth_guard() noexcept : scope(current)
+        {
+            if (scope)
+                success = ++scope->depth <= scope->value.max_depth;
+        }
+
+        ~depth_guard()
+        {
+            if (scope)
+                --scope->depth;
+        }
+
+        depth_guard(const depth_guard&) = delete;
+        depth_guard& operator=(const depth_guard&) = delete;
+
+        explicit operator bool() const noexcept
+        {
+            return success;
+        }
+
+    private:
+        limits_scope* const scope;
+        bool success = true;
+    };
+
+private:
+    static inline thread_local limits_scope* current = nullptr;
+
+    const limits value;
+    limits_scope* const previous;
+    size_t allocated = 0;
+    size_t depth = 0;
+};
+
+} // namespace srlz
+
+#endif // SRLZ_LIMITS_HPP
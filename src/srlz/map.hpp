@@ -0,0 +1,190 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_MAP_HPP
+#define SRLZ_MAP_HPP
+
+#include <map>
+#include <tuple>
+
+#include "base.hpp"
+
+namespace srlz
+{
+
+/**
+ * @brief keys are fundamental types or srlz::string, values are fundamental types or srlz types,
+ * keys are always written in ascending order
+ */
+template<typename _Key, typename _Tp>
+class map final : public base, public std::map<_Key, _Tp>
+{
+public:
+    static constexpr size_t min_serialized_size = sizeof(size_t);
+
+    virtual ~map() = default;
+    map() = default;
+    map(map&&) = default;
+    map& operator=(map&&) = default;
+
+    /**
+     * @brief a node per element, estimated as three links and the color next to the key and the value
+     */
+    virtual footprint get_footprint() const override
+    {
+        footprint result { this->size(), this->size() * (4 * sizeof(void*) + sizeof(typename std::map<_Key, _Tp>::value_type)) };
+
+        for (auto& [key, value] : *this)
+            result += footprint_of(key) + footprint_of(value);
+
+        return result;
+    }
+
+    virtual void link_entities(const serializable* const parent) const override
+    {
+        for (auto& [key, value] : *this)
+            link_item(value, parent);
+    }
+
+    virtual void describe_layout(xxh64& hash) const override
+    {
+        describe(hash, layout_tag::MAP);
+        describe_item<_Key>(hash);
+        describe_item<_Tp>(hash);
+    }
+
+    virtual bool serialize(
+        char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const override
+    {
+        const size_t length = this->size();
+
+        if (!write(static_cast<const void*>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
+            return false;
+
+        for (auto& [key, value] : *this)
+        {
+            if (!write_item(key, buffer, buffer_size, buffer_offset))
+                return false;
+
+            if (!write_item(value, buffer, buffer_size, buffer_offset))
+                return false;
+        }
+
+        return true;
+    }
+
+    virtual bool deserialize(
+        const char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const override
+    {
+        size_t length;
+
+        if (!read(static_cast<void*>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
+            return false;
+
+        if (!check_length(length, min_item_size<_Key>() + min_item_size<_Tp>(), buffer_size, buffer_offset) || !limits_scope::allocate(length, sizeof(std::pair<const _Key, _Tp>)))
+            return false;
+
+        auto& self = *((std::map<_Key, _Tp>*)this);
+
+        self.clear();
+
+        for (; length > 0; --length)
+        {
+            _Key key;
+
+            if (!read_item(key, buffer, buffer_size, buffer_offset))
+                return false;
+
+            // keys arrive sorted, so the hint makes every insertion constant time
+            auto it = self.emplace_hint(self.end(), std::piecewise_construct,
+                std::forward_as_tuple(std::move(key)), std::forward_as_tuple());
+            plan_item(it->second);
+
+            if (!read_item(it->second, buffer, buffer_size, buffer_offset))
+                return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief the length, then the key and the value of every element
+     */
+    virtual std::unique_ptr<part_cursor> encode_parts() const override
+    {
+        return make_cursor([this, length = this->size(), it = this->begin(), key = true](const size_t index, value_part& part) mutable
+        {
+            if (index == 0)
+                part = bytes_part(&length, sizeof(size_t));
+            else if (it == this->end())
+                return part_cursor::step::END;
+            else if (key)
+                part = part_of(it->first);
+            else
+                part = part_of((it++)->second);
+
+            key = index == 0 || !key;
+
+            return part_cursor::step::PART;
+        });
+    }
+
+    /**
+     * @brief a key is read into the cursor and moved into the map before its value is read
+     */
+    virtual std::unique_ptr<part_cursor> decode_parts() const override
+    {
+        return make_cursor([this, length = size_t(0), key = _Key()](const size_t index, value_part& part) mutable
+        {
+            using step = part_cursor::step;
+
+            auto& self = *((std::map<_Key, _Tp>*)this);
+
+            if (index == 0)
+            {
+                part = bytes_part(&length, sizeof(size_t));
+                return step::PART;
+            }
+
+            if (index == 1)
+            {
+                if (!limits_scope::allocate(length, sizeof(std::pair<const _Key, _Tp>)))
+                    return step::INVALID;
+
+                self.clear();
+            }
+
+            if (index % 2 == 1)
+            {
+                if (index / 2 == length)
+                    return step::END;
+
+                key = _Key();
+                part = part_of(key);
+
+                return step::PART;
+            }
+
+            auto it = self.emplace_hint(self.end(), std::piecewise_construct,
+                std::forward_as_tuple(std::move(key)), std::forward_as_tuple());
+            plan_item(it->second);
+            part = part_of(it->second);
+
+            return step::PART;
+        });
+    }
+};
+
+} // namespace srlz
+
+#endif // SRLZ_MAP_HPP
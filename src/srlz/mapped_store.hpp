@@ -0,0 +1,443 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_MAPPED_STORE_HPP
+#define SRLZ_MAPPED_STORE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "serializable.hpp"
+#include "xxhash.hpp"
+
+namespace srlz
+{
+
+/**
+ * @brief table of entities kept in a memory-mapped file, fixed-size members of every record live in the file itself,
+ * so set() and get_unsafe() change the file and a restart maps it instead of deserializing the fixed members,
+ * has_value of every member lives in the file as well, so set_has_value() and a deserialization change the file too,
+ * srlz members stay on the heap and are written to an append area by store() and checkpoint(),
+ * a value which outgrows its place is relocated to the end of the area, every value is checksummed,
+ * so a value whose write was torn by a crash is loaded as absent,
+ * records are owned by the store, must not be move-assigned and are not thread-safe
+ */
+template<typename _Tp>
+class mapped_store final
+{
+    static_assert(std::is_base_of_v<serializable, _Tp>);
+
+public:
+    /**
+     * @brief opens the file or creates it with room for capacity records, an existing file keeps its capacity,
+     * the file may grow up to max_size bytes, nullptr on failure or if the file holds records of another layout
+     */
+    static std::unique_ptr<mapped_store> open(const char* const path, const size_t capacity, const size_t max_size = size_t(1) << 32)
+    {
+        const int fd = ::open(path, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+
+        if (fd < 0)
+            return nullptr;
+
+        std::unique_ptr<mapped_store> store(new mapped_store(fd, max_size));
+
+        if (!store->initialize(capacity))
+            return nullptr;
+
+        return store;
+    }
+
+    ~mapped_store()
+    {
+        // the mapped values are not owned by the members
+        for (auto& record : records)
+            for (size_t i = 0; i < layout.size(); ++i)
+                if (layout[i].size > 0)
+                    common(*record, i).value_.release();
+
+        records.clear();
+
+        if (region != MAP_FAILED)
+            munmap(region, max_size);
+
+        close(fd);
+    }
+
+    mapped_store(const mapped_store&) = delete;
+    mapped_store& operator=(const mapped_store&) = delete;
+
+    size_t size() const noexcept
+    {
+        return records.size();
+    }
+
+    size_t capacity() const noexcept
+    {
+        return size_t(header->capacity);
+    }
+
+    _Tp& operator[](const size_t index) noexcept
+    {
+        return *records[index];
+    }
+
+    const _Tp& operator[](const size_t index) const noexcept
+    {
+        return *records[index];
+    }
+
+    /**
+     * @brief a new record with default values, nullptr if the store is full or the record cannot be written,
+     * in which case the store is left as it was
+     */
+    _Tp* append()
+    {
+        if (records.size() >= header->capacity)
+            return nullptr;
+
+        auto record = std::make_unique<_Tp>();
+        char* const slot = slot_of(records.size());
+
+        for (size_t i = 0; i < layout.size(); ++i)
+            if (layout[i].size > 0)
+                std::memcpy(slot + layout[i].offset, common(*record, i).value_.get(), layout[i].size);
+
+        // the slot is beyond count until the record is written, the extents taken by its values are given back on failure
+        const uint64_t append_end = header->append_end;
+
+        if (!store(*record, slot))
+        {
+            header->append_end = append_end;
+            return nullptr;
+        }
+
+        bind(*record, slot);
+        record->map_presence(slot);
+        records.push_back(std::move(record));
+        header->count = records.size();
+
+        return records.back().get();
+    }
+
+    /**
+     * @brief writes the srlz members of a record to the file
+     */
+    bool store(const size_t index)
+    {
+        return store(*records[index], slot_of(index));
+    }
+
+    /**
+     * @brief stores every record and flushes the file to the disk
+     */
+    bool checkpoint()
+    {
+        for (size_t i = 0; i < records.size(); ++i)
+            if (!store(i))
+                return false;
+
+        return msync(region, mapped_size, MS_SYNC) == 0;
+    }
+
+private:
+    struct file_header
+    {
+        uint64_t magic;
+        uint64_t layout_hash;
+        uint64_t record_size;
+        uint64_t capacity;
+        uint64_t count;
+        uint64_t append_end;
+    };
+
+    /**
+     * @brief place of a srlz member in the append area and the XXH64 of its bytes
+     */
+    struct extent
+    {
+        uint64_t offset;
+        uint64_t length;
+        uint64_t capacity;
+        uint64_t checksum;
+    };
+
+    /**
+     * @brief offset of a member in the record and the size of a fixed member, 0 for a srlz member, which has an extent
+     */
+    struct member_layout
+    {
+        size_t offset;
+        size_t size;
+    };
+
+    static constexpr uint64_t file_magic = 0x73726c7a6d617032;
+    static constexpr size_t records_offset = 64;
+
+    static_assert(sizeof(file_header) <= records_offset);
+
+    mapped_store(const int fd, const size_t max_size)
+        : fd(fd), max_size(max_size)
+    {
+    }
+
+    static member<int8_t, member_type::COMMON>& common(const _Tp& record, const size_t index) noexcept
+    {
+        return *static_cast<member<int8_t, member_type::COMMON>*>(record.serializable::member_vector[index]);
+    }
+
+    static size_t align(const size_t value, const size_t alignment) noexcept
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    bool initialize(const size_t capacity)
+    {
+        const _Tp prototype;
+        size_t offset = prototype.get_member_count();
+
+        for (size_t i = 0; i < prototype.get_member_count(); ++i)
+        {
+            const size_t size = fundamental_size(prototype.get_member(i).type);
+
+            offset = align(offset, size == 0 ? alignof(extent) : (size < 16 ? size : 16));
+            layout.push_back({ offset, size });
+            offset += size == 0 ? sizeof(extent) : size;
+        }
+
+        record_size = align(offset, alignof(std::max_align_t));
+
+        // srlz members of different types have to differ as well, e.g. a string and a vector of strings
+        xxh64 hash;
+        prototype.describe_layout(hash);
+        hash.update(&record_size, sizeof(record_size));
+
+        struct stat status;
+
+        if (fstat(fd, &status) != 0)
+            return false;
+
+        region = mmap(nullptr, max_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+        if (region == MAP_FAILED)
+            return false;
+
+        const bool created = status.st_size == 0;
+        const size_t records_end = records_offset + capacity * record_size;
+
+        if (!map(created ? records_end : size_t(status.st_size)))
+            return false;
+
+        header = static_cast<file_header*>(region);
+
+        if (created)
+        {
+            *header = { 0, hash.digest(), record_size, capacity, 0, records_end };
+
+            // the magic is written last so that a torn creation is not taken for a store
+            if (msync(region, mapped_size, MS_SYNC) != 0)
+                return false;
+
+            header->magic = file_magic;
+
+            return true;
+        }
+
+        if (header->magic != file_magic || header->layout_hash != hash.digest() || header->count > header->capacity
+            || records_offset + header->capacity * record_size > mapped_size || header->append_end > mapped_size)
+            return false;
+
+        for (size_t index = 0; index < header->count; ++index)
+            if (!load(index))
+                return false;
+
+        return true;
+    }
+
+    /**
+     * @brief maps the file over the reserved region, which keeps the addresses of the values stable when it grows
+     */
+    bool map(const size_t size)
+    {
+        if (size > max_size || ftruncate(fd, off_t(size)) != 0)
+            return false;
+
+        if (mmap(region, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)
+            return false;
+
+        mapped_size = size;
+
+        return true;
+    }
+
+    char* slot_of(const size_t index) const noexcept
+    {
+        return static_cast<char*>(region) + records_offset + index * record_size;
+    }
+
+    /**
+     * @brief points the fixed members of a record into its slot
+     */
+    void bind(const _Tp& record, char* const slot)
+    {
+
+#define SRLZ_BIND_FUNDAMENTAL_TYPE(T, member_type) \
+    static_cast<member<T, member_type>*>(static_cast<void*>(&mem))->value_.reset(static_cast<T*>(address));
+// SRLZ_BIND_FUNDAMENTAL_TYPE
+
+        for (size_t i = 0; i < layout.size(); ++i)
+        {
+            auto& mem = common(record, i);
+            void* const address = static_cast<void*>(slot + layout[i].offset);
+
+            switch (mem.get_type())
+            {
+            case member_type::BOOL        : { SRLZ_BIND_FUNDAMENTAL_TYPE( bool        , member_type::BOOL        ) break; }
+            case member_type::INT_8       : { SRLZ_BIND_FUNDAMENTAL_TYPE( int8_t      , member_type::INT_8       ) break; }
+            case member_type::INT_16      : { SRLZ_BIND_FUNDAMENTAL_TYPE( int16_t     , member_type::INT_16      ) break; }
+            case member_type::INT_32      : { SRLZ_BIND_FUNDAMENTAL_TYPE( int32_t     , member_type::INT_32      ) break; }
+            case member_type::INT_64      : { SRLZ_BIND_FUNDAMENTAL_TYPE( int64_t     , member_type::INT_64      ) break; }
+            case member_type::U_INT_8     : { SRLZ_BIND_FUNDAMENTAL_TYPE( uint8_t     , member_type::U_INT_8     ) break; }
+            case member_type::U_INT_16    : { SRLZ_BIND_FUNDAMENTAL_TYPE( uint16_t    , member_type::U_INT_16    ) break; }
+            case member_type::U_INT_32    : { SRLZ_BIND_FUNDAMENTAL_TYPE( uint32_t    , member_type::U_INT_32    ) break; }
+            case member_type::U_INT_64    : { SRLZ_BIND_FUNDAMENTAL_TYPE( uint64_t    , member_type::U_INT_64    ) break; }
+            case member_type::FLOAT       : { SRLZ_BIND_FUNDAMENTAL_TYPE( float       , member_type::FLOAT       ) break; }
+            case member_type::DOUBLE      : { SRLZ_BIND_FUNDAMENTAL_TYPE( double      , member_type::DOUBLE      ) break; }
+            case member_type::LONG_DOUBLE : { SRLZ_BIND_FUNDAMENTAL_TYPE( long double , member_type::LONG_DOUBLE ) break; }
+
+            default:
+                break;
+            }
+        }
+
+#undef SRLZ_BIND_FUNDAMENTAL_TYPE
+    }
+
+    /**
+     * @brief a record of an existing file: the fixed members and has_value are bound, the srlz members are deserialized,
+     * a srlz member whose extent does not match its checksum is absent
+     */
+    bool load(const size_t index)
+    {
+        auto record = std::make_unique<_Tp>();
+        char* const slot = slot_of(index);
+
+        bind(*record, slot);
+        records.push_back(std::move(record));
+
+        const _Tp& loaded = *records.back();
+
+        for (size_t i = 0; i < layout.size(); ++i)
+            common(loaded, i).has_value_ = slot[i] != 0;
+
+        loaded.map_presence(slot);
+
+        for (size_t i = 0; i < layout.size(); ++i)
+        {
+            auto& mem = common(loaded, i);
+
+            if (layout[i].size > 0 || !mem.has_value_)
+                continue;
+
+            extent place;
+            std::memcpy(&place, slot + layout[i].offset, sizeof(extent));
+
+            const char* const bytes = static_cast<const char*>(region) + place.offset;
+
+            if (place.offset > mapped_size || place.length > mapped_size - place.offset
+                || xxh64::hash(bytes, place.length) != place.checksum)
+            {
+                mem.set_has_value(false);
+                continue;
+            }
+
+            size_t offset = 0;
+            const base& value = *static_cast<const base*>(static_cast<const void*>(mem.value_.get()));
+
+            if (!value.deserialize(bytes, place.length, offset))
+                return false;
+        }
+
+        return true;
+    }
+
+    bool store(const _Tp& record, char* const slot)
+    {
+        for (size_t i = 0; i < layout.size(); ++i)
+        {
+            auto& mem = common(record, i);
+
+            if (layout[i].size == 0 && mem.has_value_ && !store_value(mem, slot + layout[i].offset))
+                return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief writes a srlz member in place or relocates it to the end of the append area
+     */
+    bool store_value(const member<int8_t, member_type::COMMON>& mem, char* const place_address)
+    {
+        const base& value = *static_cast<const base*>(static_cast<const void*>(mem.value_.get()));
+        const size_t checkpoint = dictionary_scope::checkpoint();
+        size_t length;
+
+        while (!value.serialize(scratch.data(), scratch.size(), length = 0))
+        {
+            dictionary_scope::rollback(checkpoint);
+
+            if (scratch.size() >= max_size)
+                return false;
+
+            scratch.resize(scratch.empty() ? 256 : scratch.size() * 2);
+        }
+
+        extent place;
+        std::memcpy(&place, place_address, sizeof(extent));
+
+        if (length > place.capacity)
+        {
+            const size_t new_capacity = align(length + length / 2, alignof(std::max_align_t));
+            const size_t end = size_t(header->append_end) + new_capacity;
+
+            if (end > mapped_size && !map(std::max(end, mapped_size * 2 < max_size ? mapped_size * 2 : max_size)))
+                return false;
+
+            place = { header->append_end, 0, new_capacity, 0 };
+            header->append_end = end;
+        }
+
+        std::memcpy(static_cast<char*>(region) + place.offset, scratch.data(), length);
+        place.length = length;
+        place.checksum = xxh64::hash(scratch.data(), length);
+        std::memcpy(place_address, &place, sizeof(extent));
+
+        return true;
+    }
+
+    const int fd;
+    const size_t max_size;
+    void* region = MAP_FAILED;
+    size_t mapped_size = 0;
+    size_t record_size = 0;
+    file_header* header = nullptr;
+    std::vector<member_layout> layout;
+    std::vector<std::unique_ptr<_Tp>> records;
+    std::vector<char> scratch;
+};
+
+} // namespace srlz
+
+#endif // SRLZ_MAPPED_STORE_HPP
@@ -0,0 +1,81 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_MAX_SERIALIZED_SIZE_HPP
+#define SRLZ_MAX_SERIALIZED_SIZE_HPP
+
+#include <array>
+#include <cassert>
+#include <type_traits>
+
+#include "member_type.h"
+
+namespace srlz
+{
+
+template<typename T, typename = void>
+struct has_max_serialized_size : std::false_type {};
+
+template<typename T>
+struct has_max_serialized_size<T, std::void_t<decltype(T::max_serialized_size)>> : std::true_type {};
+
+/**
+ * @brief maximum size of a member, a fundamental member takes its type size, a SRLZ member
+ * has to provide a static constexpr max_serialized_size like srlz::array does
+ */
+template<typename _Member>
+constexpr size_t max_serialized_size_of() noexcept
+{
+    if constexpr (_Member::type == member_type::SRLZ)
+    {
+        static_assert(has_max_serialized_size<typename _Member::value_type>::value,
+            "SRLZ member has no fixed layout");
+
+        return sizeof(bool) + _Member::value_type::max_serialized_size;
+    }
+    else
+    {
+        static_assert(fundamental_size(_Member::type) > 0);
+
+        return sizeof(bool) + fundamental_size(_Member::type);
+    }
+}
+
+/**
+ * @brief maximum serialized size of an entity with the listed members, every member counts as present,
+ * use it to declare the static constexpr max_serialized_size of an entity:
+ *
+ * static constexpr size_t max_serialized_size = srlz::max_serialized_size<decltype(a), decltype(b)>();
+ */
+template<typename... _Members>
+constexpr size_t max_serialized_size() noexcept
+{
+    return (max_serialized_size_of<_Members>() + ... + size_t(0));
+}
+
+/**
+ * @brief asserts once per class that the max_serialized_size declared by _Entity is the one of its member_vector,
+ * so a list of member types which went out of sync with it is caught before a message outgrows its buffer
+ */
+template<typename _Entity>
+void assert_max_serialized_size([[maybe_unused]] const _Entity& entity) noexcept
+{
+#ifndef NDEBUG
+    static const bool matches = entity.get_max_size() == _Entity::max_serialized_size;
+    assert(matches);
+#endif
+}
+
+/**
+ * @brief stack buffer which always fits a serialized T
+ */
+template<typename T>
+using serialized_buffer = std::array<char, T::max_serialized_size>;
+
+} // namespace srlz
+
+#endif // SRLZ_MAX_SERIALIZED_SIZE_HPP
@@ -8,7 +8,10 @@
 #ifndef SRLZ_MEMBER_HPP
 #define SRLZ_MEMBER_HPP
 
+#include <cstdint>
 #include <memory>
+#include <type_traits>
+#include <utility>
 
 #include "member_type.h"
 
@@ -17,12 +20,44 @@ namespace srlz
 
 class serializable;
 
+template<class _Derived>
+class static_serializable;
+
+template<typename _Tp>
+class mapped_store;
+
+/**
+ * @brief drops the cached bytes of an entity and of the entities it is nested in, called after a member has changed
+ */
+inline void invalidate_cache(const serializable* owner) noexcept;
+
 template<class T, member_type mt>
 class member
 {
+    static_assert(sizeof(T) <= UINT32_MAX);
+
 public:
     friend class serializable;
 
+    template<class _Derived>
+    friend class static_serializable;
+
+    template<typename _Tp>
+    friend class mapped_store;
+
+    using value_type = T;
+
+    static constexpr member_type type = mt;
+
+    /**
+     * @brief a nested entity is of type T itself and takes the plan of its class
+     */
+    member()
+    {
+        if constexpr (mt == member_type::SRLZ && std::is_base_of_v<serializable, T>)
+            value_->template use_class_plan<T>();
+    }
+
     /**
      * @brief first you need to check if the value exists by calling has_value()
      */
@@ -42,6 +77,9 @@ public:
         if (!has_value_)
             throw -1;
 
+        if (owner_)
+            invalidate_cache(owner_);
+
         return *value_.get();
     }
 
@@ -49,6 +87,9 @@ public:
     {
         has_value_ = true;
         *value_.get() = value;
+
+        if (owner_)
+            invalidate_cache(owner_);
     }
 
     const bool& has_value() const noexcept
@@ -59,6 +100,9 @@ public:
     void set_has_value(bool value) noexcept
     {
         has_value_ = value;
+
+        if (owner_)
+            invalidate_cache(owner_);
     }
 
     const member_type& get_type() const noexcept
@@ -67,9 +111,17 @@ public:
     }
 
 private:
+    void swap(member& other) noexcept
+    {
+        std::swap(has_value_, other.has_value_);
+        value_.swap(other.value_);
+    }
+
     const member_type type_ = mt;
     bool has_value_ = true;
+    const uint32_t size_ = sizeof(T);
     std::unique_ptr<T> value_ { new T };
+    const serializable* owner_ = nullptr;
 };
 
 } // namespace srlz
@@ -8,6 +8,8 @@
 #ifndef SRLZ_MEMBER_TYPE_H
 #define SRLZ_MEMBER_TYPE_H
 
+#include <cstdint>
+#include <cstddef>
 #include <type_traits>
 
 namespace srlz
@@ -33,6 +35,51 @@ enum class member_type : uint8_t
     SRLZ,
 };
 
+/**
+ * @brief number of bytes a fundamental member takes in the buffer, 0 for COMMON and SRLZ
+ */
+constexpr size_t fundamental_size(member_type type) noexcept
+{
+    switch (type)
+    {
+    case member_type::BOOL        : return sizeof( bool        );
+    case member_type::INT_8       : return sizeof( int8_t      );
+    case member_type::INT_16      : return sizeof( int16_t     );
+    case member_type::INT_32      : return sizeof( int32_t     );
+    case member_type::INT_64      : return sizeof( int64_t     );
+    case member_type::U_INT_8     : return sizeof( uint8_t     );
+    case member_type::U_INT_16    : return sizeof( uint16_t    );
+    case member_type::U_INT_32    : return sizeof( uint32_t    );
+    case member_type::U_INT_64    : return sizeof( uint64_t    );
+    case member_type::FLOAT       : return sizeof( float       );
+    case member_type::DOUBLE      : return sizeof( double      );
+    case member_type::LONG_DOUBLE : return sizeof( long double );
+    default                       : return 0;
+    }
+}
+
+/**
+ * @brief the member_type of a fundamental type
+ */
+template<typename T>
+constexpr member_type member_type_of() noexcept
+{
+    static_assert(std::is_arithmetic_v<T>);
+
+    if constexpr (std::is_same_v<T, bool>)
+        return member_type::BOOL;
+    else if constexpr (std::is_same_v<T, float>)
+        return member_type::FLOAT;
+    else if constexpr (std::is_same_v<T, double>)
+        return member_type::DOUBLE;
+    else if constexpr (std::is_same_v<T, long double>)
+        return member_type::LONG_DOUBLE;
+    else if constexpr (std::is_signed_v<T>)
+        return sizeof(T) == 1 ? member_type::INT_8 : sizeof(T) == 2 ? member_type::INT_16 : sizeof(T) == 4 ? member_type::INT_32 : member_type::INT_64;
+    else
+        return sizeof(T) == 1 ? member_type::U_INT_8 : sizeof(T) == 2 ? member_type::U_INT_16 : sizeof(T) == 4 ? member_type::U_INT_32 : member_type::U_INT_64;
+}
+
 } // namespace srlz
 
 #endif // SRLZ_MEMBER_TYPE_H
@@ -16,46 +16,119 @@ namespace srlz
 {
 
 /**
- * @brief you have to allocate and deallocate memory yourself
+ * @brief you have to allocate and deallocate memory yourself,
+ * an incoming size larger than capacity is rejected, blob owns its buffer
  */
 class memory final : public base
 {
 public:
     virtual ~memory() = default;
 
+    virtual void describe_layout(xxh64& hash) const override
+    {
+        describe(hash, layout_tag::MEMORY);
+    }
+
     virtual bool serialize(
         char* const buffer,
         const size_t buffer_size,
         size_t& buffer_offset
         ) const override
     {
-        if (!write(static_cast<const void* const>(&size), sizeof(size_t), buffer, buffer_size, buffer_offset))
+        if (!write(static_cast<const void*>(&size), sizeof(size_t), buffer, buffer_size, buffer_offset))
             return false;
 
-        if (!write(static_cast<const void* const>(pointer), size, buffer, buffer_size, buffer_offset))
+        if (!write(static_cast<const void*>(pointer), size, buffer, buffer_size, buffer_offset))
             return false;
 
         return true;
     }
 
+    virtual bool gather(iovec_list& list) const override
+    {
+        list.copy(static_cast<const void*>(&size), sizeof(size_t));
+        list.append(static_cast<const void*>(pointer), size);
+
+        return true;
+    }
+
     virtual bool deserialize(
         const char* const buffer,
         const size_t buffer_size,
         size_t& buffer_offset
         ) const override
     {
-        if (!read(static_cast<void* const>(const_cast<size_t* const>(&size)),
-            sizeof(size_t), buffer, buffer_size, buffer_offset))
+        size_t length;
+
+        if (!read(static_cast<void*>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
             return false;
 
-        if (!read(static_cast<void* const>(pointer), size, buffer, buffer_size, buffer_offset))
+        auto& self = const_cast<memory&>(*this);
+
+        if (self.capacity == 0)
+            self.capacity = size;
+
+        if (length > capacity)
+            return false;
+
+        self.size = length;
+
+        if (!read(static_cast<void*>(pointer), size, buffer, buffer_size, buffer_offset))
             return false;
 
         return true;
     }
 
-    unsigned char* pointer;
-    size_t size;
+    virtual std::unique_ptr<part_cursor> encode_parts() const override
+    {
+        return make_cursor([this](const size_t index, value_part& part)
+        {
+            if (index > 1)
+                return part_cursor::step::END;
+
+            part = index == 0 ? bytes_part(&size, sizeof(size_t)) : bytes_part(pointer, size);
+
+            return part_cursor::step::PART;
+        });
+    }
+
+    virtual std::unique_ptr<part_cursor> decode_parts() const override
+    {
+        return make_cursor([this, length = size_t(0)](const size_t index, value_part& part) mutable
+        {
+            using step = part_cursor::step;
+
+            if (index == 0)
+            {
+                part = bytes_part(&length, sizeof(size_t));
+                return step::PART;
+            }
+
+            if (index > 1)
+                return step::END;
+
+            auto& self = const_cast<memory&>(*this);
+
+            if (self.capacity == 0)
+                self.capacity = size;
+
+            if (length > capacity)
+                return step::INVALID;
+
+            self.size = length;
+            part = bytes_part(pointer, size);
+
+            return step::PART;
+        });
+    }
+
+    unsigned char* pointer = nullptr;
+    size_t size = 0;
+
+    /**
+     * @brief bytes pointer can hold, taken from size on the first deserialization if it is not set
+     */
+    size_t capacity = 0;
 };
 
 } // namespace srlz
@@ -0,0 +1,75 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_PARTS_HPP
+#define SRLZ_PARTS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "member_type.h"
+
+namespace srlz
+{
+
+class base;
+
+/**
+ * @brief a piece of a value which is streamed in order: either fundamental values of type
+ * in [data, data + length) or a nested value with parts of its own
+ */
+struct value_part
+{
+    const base* value = nullptr;
+    void* data = nullptr;
+    size_t length = 0;
+    member_type type = member_type::U_INT_8;
+};
+
+/**
+ * @brief walks the parts of one value, a cursor which reads gets the bytes of a part before it is asked for the next one,
+ * so a length it has read decides what follows
+ */
+class part_cursor
+{
+public:
+    enum class step : uint8_t
+    {
+        PART,
+        END,
+        INVALID
+    };
+
+    virtual ~part_cursor() = default;
+
+    virtual step next(value_part& part) = 0;
+};
+
+/**
+ * @brief a cursor which calls function with the index of the part and the part to fill
+ */
+template<typename _Function>
+class function_cursor final : public part_cursor
+{
+public:
+    explicit function_cursor(_Function&& function) : function(std::move(function)) {}
+
+    virtual step next(value_part& part) override
+    {
+        return function(index++, part);
+    }
+
+private:
+    _Function function;
+    size_t index = 0;
+};
+
+} // namespace srlz
+
+#endif // SRLZ_PARTS_HPP
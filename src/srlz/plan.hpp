@@ -0,0 +1,108 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_PLAN_HPP
+#define SRLZ_PLAN_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace srlz
+{
+
+/**
+ * @brief layout of the members of one class, built once per class:
+ * consecutive fundamental members form a run, which is checked against the buffer once
+ * and then copied without further checks, every srlz member is a run of its own,
+ * the fixed members of a nested entity are not flattened into the runs of its parent,
+ * since its class may override serialize or its instance may be cached, so it goes through its own plan
+ */
+class serialization_plan final
+{
+public:
+    struct run
+    {
+        uint32_t first;
+        uint32_t count;
+
+        /**
+         * @brief the bytes of the run when every member has a value, 0 for a srlz member
+         */
+        size_t max_size;
+    };
+
+    std::vector<run> runs;
+
+    /**
+     * @brief the size of every fundamental member, 0 for a srlz member
+     */
+    std::vector<uint8_t> sizes;
+
+    static const serialization_plan* find(const std::type_info& type)
+    {
+        auto& [mutex, plans] = registry();
+        std::shared_lock lock(mutex);
+
+        const auto it = plans.find(type);
+
+        return it != plans.end() ? it->second.get() : nullptr;
+    }
+
+    /**
+     * @brief the plan of another thread wins if it was added first
+     */
+    static const serialization_plan& add(const std::type_info& type, serialization_plan&& plan)
+    {
+        auto& [mutex, plans] = registry();
+        std::unique_lock lock(mutex);
+
+        const auto [it, inserted] = plans.emplace(type, nullptr);
+
+        if (inserted)
+            it->second = std::make_unique<const serialization_plan>(std::move(plan));
+
+        return *it->second;
+    }
+
+    void append(const uint32_t index, const size_t size)
+    {
+        sizes.push_back(uint8_t(size));
+
+        if (size == 0)
+            runs.push_back({ index, 1, 0 });
+        else if (runs.empty() || runs.back().max_size == 0)
+            runs.push_back({ index, 1, sizeof(bool) + size });
+        else
+        {
+            ++runs.back().count;
+            runs.back().max_size += sizeof(bool) + size;
+        }
+    }
+
+private:
+    struct plans_registry
+    {
+        std::shared_mutex mutex;
+        std::unordered_map<std::type_index, std::unique_ptr<const serialization_plan>> plans;
+    };
+
+    static plans_registry& registry()
+    {
+        static plans_registry instance;
+
+        return instance;
+    }
+};
+
+} // namespace srlz
+
+#endif // SRLZ_PLAN_HPP
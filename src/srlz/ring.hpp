@@ -0,0 +1,344 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_RING_HPP
+#define SRLZ_RING_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+
+#include "base.hpp"
+#include "max_serialized_size.hpp"
+
+namespace srlz
+{
+
+enum class producer_mode : uint8_t
+{
+    SINGLE,
+    MULTIPLE,
+};
+
+/**
+ * @brief bounded channel of serialized messages for one consumer,
+ * a producer reserves space for the largest size of its message, serializes straight into it and commits the real size,
+ * the consumer deserializes straight from the ring,
+ * with SINGLE producer every operation is wait-free, with MULTIPLE producers reservation is lock-free,
+ * the ring can live in memory it does not own, e.g. memory shared between processes
+ */
+template<producer_mode pm>
+class ring final
+{
+public:
+    struct reservation
+    {
+        char* data = nullptr;
+        size_t size = 0;
+        uint64_t position = 0;
+        uint64_t end = 0;
+    };
+
+    struct view
+    {
+        const char* data = nullptr;
+        size_t size = 0;
+    };
+
+    /**
+     * @brief bytes of memory needed for a ring of capacity bytes, capacity has to be a power of two
+     */
+    static constexpr size_t required_size(const size_t capacity) noexcept
+    {
+        return sizeof(control) + capacity;
+    }
+
+    /**
+     * @brief a ring which owns its memory
+     */
+    explicit ring(const size_t capacity)
+        : storage(new (std::align_val_t(alignof(control))) char[required_size(capacity)])
+    {
+        attach(storage.get(), capacity, true);
+    }
+
+    /**
+     * @brief a ring in external memory of required_size(capacity) bytes aligned to 64,
+     * exactly one of the users initializes it
+     */
+    ring(void* const memory, const size_t capacity, const bool initialize)
+    {
+        attach(memory, capacity, initialize);
+    }
+
+    ring(const ring&) = delete;
+    ring& operator=(const ring&) = delete;
+
+    size_t capacity() const noexcept
+    {
+        return size_t(mask) + 1;
+    }
+
+    /**
+     * @brief whether a message of max_size bytes fits into the empty ring
+     */
+    bool fits(const size_t max_size) const noexcept
+    {
+        return max_size <= size_mask && align(sizeof(record_header) + max_size) <= capacity();
+    }
+
+    /**
+     * @brief an empty reservation if the ring is full or max_size can never fit,
+     * with SINGLE producer only one reservation can be open at a time,
+     * if the record does not fit at the end of the ring even when it is empty, the end is skipped on its own,
+     * so a retry succeeds once the consumer has passed it
+     */
+    reservation try_reserve(const size_t max_size) noexcept
+    {
+        if (!fits(max_size))
+            return {};
+
+        const uint64_t length = align(sizeof(record_header) + max_size);
+
+        uint64_t head = header->head.load(std::memory_order_relaxed);
+        uint64_t padding;
+
+        while (true)
+        {
+            const uint64_t contiguous = capacity() - (head & mask);
+            padding = length > contiguous ? contiguous : 0;
+
+            if (padding > 0 && padding + length > capacity())
+            {
+                if (head + padding - header->tail.load(std::memory_order_acquire) > capacity())
+                    return {};
+
+                if constexpr (pm == producer_mode::SINGLE)
+                {
+                    publish(head, padding, padding_flag);
+                    header->head.store(head + padding, std::memory_order_release);
+                    head += padding;
+                }
+                else if (header->head.compare_exchange_weak(head, head + padding, std::memory_order_relaxed))
+                {
+                    publish(head, padding, padding_flag);
+                    head += padding;
+                }
+
+                continue;
+            }
+
+            if (head + padding + length - header->tail.load(std::memory_order_acquire) > capacity())
+                return {};
+
+            if constexpr (pm == producer_mode::SINGLE)
+                break;
+            else if (header->head.compare_exchange_weak(head, head + padding + length, std::memory_order_relaxed))
+                break;
+        }
+
+        if (padding > 0)
+            publish(head, padding, padding_flag);
+
+        const uint64_t position = head + padding;
+
+        return { data + (position & mask) + sizeof(record_header), size_t(length - sizeof(record_header)),
+            position, position + length };
+    }
+
+    /**
+     * @brief publishes the first size bytes of the reservation, a zero size with cancel skips the reservation
+     */
+    void commit(reservation& slot, const size_t size, const bool cancel = false) noexcept
+    {
+        assert(size <= slot.size);
+
+        publish(slot.position, slot.end - slot.position, cancel ? padding_flag : size);
+
+        if constexpr (pm == producer_mode::SINGLE)
+            header->head.store(slot.end, std::memory_order_release);
+
+        slot = {};
+    }
+
+    /**
+     * @brief false if the ring is full or the message does not fit max_size
+     */
+    bool try_push(const base& message, const size_t max_size)
+    {
+        reservation slot = try_reserve(max_size);
+
+        if (!slot.data)
+            return false;
+
+        size_t offset = 0;
+        const bool success = message.serialize(slot.data, slot.size, offset);
+        commit(slot, success ? offset : 0, !success);
+
+        return success;
+    }
+
+    template<typename T>
+    bool try_push(const T& message)
+    {
+        assert_max_serialized_size(message);
+
+        return try_push(message, T::max_serialized_size);
+    }
+
+    /**
+     * @brief the oldest committed message or an empty view, it stays valid until release()
+     */
+    view peek() noexcept
+    {
+        while (true)
+        {
+            const uint64_t tail = header->tail.load(std::memory_order_relaxed);
+
+            if (tail == header->head.load(std::memory_order_acquire))
+                return {};
+
+            auto& record = at(tail);
+            const uint32_t state = record.state.load(std::memory_order_acquire);
+
+            if (!(state & committed_flag))
+                return {};
+
+            if (state & padding_flag)
+            {
+                release();
+
+                continue;
+            }
+
+            return { reinterpret_cast<const char*>(&record) + sizeof(record_header), size_t(state & size_mask) };
+        }
+    }
+
+    /**
+     * @brief frees the message returned by peek()
+     */
+    void release() noexcept
+    {
+        const uint64_t tail = header->tail.load(std::memory_order_relaxed);
+        const uint32_t length = at(tail).length;
+
+        // with several producers a record header is published by its state word only,
+        // so the space is zeroed to not leave stale states for the next lap
+        if constexpr (pm == producer_mode::MULTIPLE)
+            std::memset(static_cast<void*>(&at(tail)), 0, length);
+
+        header->tail.store(tail + length, std::memory_order_release);
+    }
+
+    /**
+     * @brief false if the ring is empty or the message could not be deserialized, the message is consumed anyway
+     */
+    bool try_pop(const base& message)
+    {
+        const view record = peek();
+
+        if (!record.data)
+            return false;
+
+        size_t offset = 0;
+        const bool success = message.deserialize(record.data, record.size, offset);
+        release();
+
+        return success;
+    }
+
+    /**
+     * @brief bytes released by the consumer so far, including skipped ends of the ring
+     */
+    uint64_t released() const noexcept
+    {
+        return header->tail.load(std::memory_order_acquire);
+    }
+
+    bool empty() const noexcept
+    {
+        return header->tail.load(std::memory_order_acquire) == header->head.load(std::memory_order_acquire);
+    }
+
+private:
+    struct control
+    {
+        alignas(64) std::atomic<uint64_t> head;
+        alignas(64) std::atomic<uint64_t> tail;
+    };
+
+    struct record_header
+    {
+        std::atomic<uint32_t> state;
+        uint32_t length;
+    };
+
+    static_assert(sizeof(record_header) == 8);
+    static_assert(std::atomic<uint32_t>::is_always_lock_free);
+    static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+    static constexpr uint32_t committed_flag = uint32_t(1) << 31;
+    static constexpr uint32_t padding_flag = uint32_t(1) << 30;
+    static constexpr uint32_t size_mask = padding_flag - 1;
+
+    static constexpr uint64_t align(const uint64_t size) noexcept
+    {
+        return (size + 7) & ~uint64_t(7);
+    }
+
+    void attach(void* const memory, const size_t capacity, const bool initialize) noexcept
+    {
+        assert(capacity >= sizeof(record_header) && (capacity & (capacity - 1)) == 0);
+
+        header = static_cast<control*>(memory);
+        data = static_cast<char*>(memory) + sizeof(control);
+        mask = capacity - 1;
+
+        if (!initialize)
+            return;
+
+        new (header) control{};
+        std::memset(data, 0, capacity);
+    }
+
+    record_header& at(const uint64_t position) const noexcept
+    {
+        return *reinterpret_cast<record_header*>(data + (position & mask));
+    }
+
+    void publish(const uint64_t position, const uint64_t length, const uint32_t state) noexcept
+    {
+        auto& record = at(position);
+        record.length = uint32_t(length);
+        record.state.store(committed_flag | state, std::memory_order_release);
+    }
+
+    struct aligned_delete
+    {
+        void operator()(char* const memory) const noexcept
+        {
+            operator delete[](memory, std::align_val_t(alignof(control)));
+        }
+    };
+
+    std::unique_ptr<char[], aligned_delete> storage;
+    control* header;
+    char* data;
+    uint64_t mask;
+};
+
+using spsc_ring = ring<producer_mode::SINGLE>;
+
+using mpsc_ring = ring<producer_mode::MULTIPLE>;
+
+} // namespace srlz
+
+#endif // SRLZ_RING_HPP
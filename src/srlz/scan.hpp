@@ -0,0 +1,400 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_SCAN_HPP
+#define SRLZ_SCAN_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "columnar.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && defined(__SSE2__)
+#define SRLZ_SCAN_X86
+#include <immintrin.h>
+#endif
+
+namespace srlz
+{
+
+enum class predicate_kind : uint8_t
+{
+    EQUAL,
+    LESS,
+    GREATER,
+    RANGE,
+    BITMASK,
+};
+
+/**
+ * @brief condition on a fundamental member, RANGE includes both bounds, BITMASK matches values with any of the bits
+ */
+template<typename T>
+struct predicate
+{
+    static_assert(std::is_arithmetic_v<T>);
+
+    predicate_kind kind;
+    T low;
+    T high;
+
+    static predicate equal(const T value) noexcept { return { predicate_kind::EQUAL, value, value }; }
+    static predicate less(const T value) noexcept { return { predicate_kind::LESS, value, value }; }
+    static predicate greater(const T value) noexcept { return { predicate_kind::GREATER, value, value }; }
+    static predicate range(const T low, const T high) noexcept { return { predicate_kind::RANGE, low, high }; }
+
+    static predicate bitmask(const T mask) noexcept
+    {
+        static_assert(std::is_integral_v<T>);
+
+        return { predicate_kind::BITMASK, mask, mask };
+    }
+
+    bool operator()(const T value) const noexcept
+    {
+        switch (kind)
+        {
+        case predicate_kind::EQUAL   : return value == low;
+        case predicate_kind::LESS    : return value < low;
+        case predicate_kind::GREATER : return value > low;
+        case predicate_kind::RANGE   : return low <= value && value <= high;
+
+        case predicate_kind::BITMASK:
+            if constexpr (std::is_integral_v<T>)
+                return (value & low) != 0;
+            else
+                return false;
+        }
+
+        return false;
+    }
+};
+
+enum class scan_isa : uint8_t
+{
+    SCALAR,
+    SSE2,
+    AVX2,
+};
+
+/**
+ * @brief the widest kernels this processor runs
+ */
+inline scan_isa detect_scan_isa() noexcept
+{
+#ifdef SRLZ_SCAN_X86
+    static const scan_isa detected = __builtin_cpu_supports("avx2") ? scan_isa::AVX2 : scan_isa::SSE2;
+
+    return detected;
+#else
+    return scan_isa::SCALAR;
+#endif
+}
+
+namespace scan_detail
+{
+
+template<typename T, typename _Match>
+void scalar_loop(const column_view<T>& column, size_t begin, std::vector<size_t>& matches, const _Match& match)
+{
+    for (; begin < column.size(); ++begin)
+        if (column.has_value(begin) && match(column[begin]))
+            matches.push_back(begin);
+}
+
+/**
+ * @brief the kind is dispatched once, not per value
+ */
+template<typename T>
+void scalar_scan(const column_view<T>& column, const predicate<T>& condition, const size_t begin, std::vector<size_t>& matches)
+{
+    const T low = condition.low;
+    const T high = condition.high;
+
+    switch (condition.kind)
+    {
+    case predicate_kind::EQUAL   : scalar_loop(column, begin, matches, [low](const T value) { return value == low; }); break;
+    case predicate_kind::LESS    : scalar_loop(column, begin, matches, [low](const T value) { return value < low; }); break;
+    case predicate_kind::GREATER : scalar_loop(column, begin, matches, [low](const T value) { return value > low; }); break;
+    case predicate_kind::RANGE   : scalar_loop(column, begin, matches, [low, high](const T value) { return low <= value && value <= high; }); break;
+    default                      : scalar_loop(column, begin, matches, condition); break;
+    }
+}
+
+inline unsigned presence_bits(const uint8_t* const presence, const size_t index, const size_t lanes) noexcept
+{
+    return (unsigned(presence[index >> 3]) >> (index & 7)) & ((1U << lanes) - 1);
+}
+
+inline void emit(unsigned bits, const size_t index, std::vector<size_t>& matches)
+{
+    while (bits)
+    {
+        matches.push_back(index + size_t(__builtin_ctz(bits)));
+        bits &= bits - 1;
+    }
+}
+
+#ifdef SRLZ_SCAN_X86
+
+#define SRLZ_AVX2 __attribute__((target("avx2")))
+
+/**
+ * @brief kernels exist for the types which the instruction set compares natively
+ */
+template<typename T> struct sse2_ops;
+template<typename T> struct avx2_ops;
+
+template<>
+struct sse2_ops<int32_t>
+{
+    using vector_type = __m128i;
+    static constexpr size_t lanes = 4;
+
+    static vector_type load(const char* p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static vector_type set(const int32_t v) noexcept { return _mm_set1_epi32(v); }
+    static vector_type equal(vector_type a, vector_type b) noexcept { return _mm_cmpeq_epi32(a, b); }
+    static vector_type less(vector_type a, vector_type b) noexcept { return _mm_cmplt_epi32(a, b); }
+    static vector_type greater(vector_type a, vector_type b) noexcept { return _mm_cmpgt_epi32(a, b); }
+    static vector_type both(vector_type a, vector_type b) noexcept { return _mm_and_si128(a, b); }
+    static vector_type neither(vector_type a, vector_type b) noexcept { return _mm_xor_si128(_mm_or_si128(a, b), _mm_set1_epi32(-1)); }
+
+    static vector_type any_bits(vector_type a, vector_type mask) noexcept
+    {
+        return _mm_xor_si128(_mm_cmpeq_epi32(_mm_and_si128(a, mask), _mm_setzero_si128()), _mm_set1_epi32(-1));
+    }
+
+    static unsigned bits(vector_type a) noexcept { return unsigned(_mm_movemask_ps(_mm_castsi128_ps(a))); }
+};
+
+template<>
+struct sse2_ops<float>
+{
+    using vector_type = __m128;
+    static constexpr size_t lanes = 4;
+
+    static vector_type load(const char* p) noexcept { return _mm_loadu_ps(reinterpret_cast<const float*>(p)); }
+    static vector_type set(const float v) noexcept { return _mm_set1_ps(v); }
+    static vector_type equal(vector_type a, vector_type b) noexcept { return _mm_cmpeq_ps(a, b); }
+    static vector_type less(vector_type a, vector_type b) noexcept { return _mm_cmplt_ps(a, b); }
+    static vector_type greater(vector_type a, vector_type b) noexcept { return _mm_cmpgt_ps(a, b); }
+    static vector_type both(vector_type a, vector_type b) noexcept { return _mm_and_ps(a, b); }
+    static vector_type not_less(vector_type a, vector_type b) noexcept { return _mm_cmpnlt_ps(a, b); }
+    static vector_type not_greater(vector_type a, vector_type b) noexcept { return _mm_cmpngt_ps(a, b); }
+    static unsigned bits(vector_type a) noexcept { return unsigned(_mm_movemask_ps(a)); }
+};
+
+template<>
+struct sse2_ops<double>
+{
+    using vector_type = __m128d;
+    static constexpr size_t lanes = 2;
+
+    static vector_type load(const char* p) noexcept { return _mm_loadu_pd(reinterpret_cast<const double*>(p)); }
+    static vector_type set(const double v) noexcept { return _mm_set1_pd(v); }
+    static vector_type equal(vector_type a, vector_type b) noexcept { return _mm_cmpeq_pd(a, b); }
+    static vector_type less(vector_type a, vector_type b) noexcept { return _mm_cmplt_pd(a, b); }
+    static vector_type greater(vector_type a, vector_type b) noexcept { return _mm_cmpgt_pd(a, b); }
+    static vector_type both(vector_type a, vector_type b) noexcept { return _mm_and_pd(a, b); }
+    static vector_type not_less(vector_type a, vector_type b) noexcept { return _mm_cmpnlt_pd(a, b); }
+    static vector_type not_greater(vector_type a, vector_type b) noexcept { return _mm_cmpngt_pd(a, b); }
+    static unsigned bits(vector_type a) noexcept { return unsigned(_mm_movemask_pd(a)); }
+};
+
+template<>
+struct avx2_ops<int32_t>
+{
+    using vector_type = __m256i;
+    static constexpr size_t lanes = 8;
+
+    SRLZ_AVX2 static vector_type load(const char* p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    SRLZ_AVX2 static vector_type set(const int32_t v) noexcept { return _mm256_set1_epi32(v); }
+    SRLZ_AVX2 static vector_type equal(vector_type a, vector_type b) noexcept { return _mm256_cmpeq_epi32(a, b); }
+    SRLZ_AVX2 static vector_type less(vector_type a, vector_type b) noexcept { return _mm256_cmpgt_epi32(b, a); }
+    SRLZ_AVX2 static vector_type greater(vector_type a, vector_type b) noexcept { return _mm256_cmpgt_epi32(a, b); }
+    SRLZ_AVX2 static vector_type both(vector_type a, vector_type b) noexcept { return _mm256_and_si256(a, b); }
+    SRLZ_AVX2 static vector_type neither(vector_type a, vector_type b) noexcept { return _mm256_xor_si256(_mm256_or_si256(a, b), _mm256_set1_epi32(-1)); }
+
+    SRLZ_AVX2 static vector_type any_bits(vector_type a, vector_type mask) noexcept
+    {
+        return _mm256_xor_si256(_mm256_cmpeq_epi32(_mm256_and_si256(a, mask), _mm256_setzero_si256()), _mm256_set1_epi32(-1));
+    }
+
+    SRLZ_AVX2 static unsigned bits(vector_type a) noexcept { return unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(a))); }
+};
+
+template<>
+struct avx2_ops<int64_t>
+{
+    using vector_type = __m256i;
+    static constexpr size_t lanes = 4;
+
+    SRLZ_AVX2 static vector_type load(const char* p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    SRLZ_AVX2 static vector_type set(const int64_t v) noexcept { return _mm256_set1_epi64x(v); }
+    SRLZ_AVX2 static vector_type equal(vector_type a, vector_type b) noexcept { return _mm256_cmpeq_epi64(a, b); }
+    SRLZ_AVX2 static vector_type less(vector_type a, vector_type b) noexcept { return _mm256_cmpgt_epi64(b, a); }
+    SRLZ_AVX2 static vector_type greater(vector_type a, vector_type b) noexcept { return _mm256_cmpgt_epi64(a, b); }
+    SRLZ_AVX2 static vector_type both(vector_type a, vector_type b) noexcept { return _mm256_and_si256(a, b); }
+    SRLZ_AVX2 static vector_type neither(vector_type a, vector_type b) noexcept { return _mm256_xor_si256(_mm256_or_si256(a, b), _mm256_set1_epi32(-1)); }
+
+    SRLZ_AVX2 static vector_type any_bits(vector_type a, vector_type mask) noexcept
+    {
+        return _mm256_xor_si256(_mm256_cmpeq_epi64(_mm256_and_si256(a, mask), _mm256_setzero_si256()), _mm256_set1_epi32(-1));
+    }
+
+    SRLZ_AVX2 static unsigned bits(vector_type a) noexcept { return unsigned(_mm256_movemask_pd(_mm256_castsi256_pd(a))); }
+};
+
+template<>
+struct avx2_ops<float>
+{
+    using vector_type = __m256;
+    static constexpr size_t lanes = 8;
+
+    SRLZ_AVX2 static vector_type load(const char* p) noexcept { return _mm256_loadu_ps(reinterpret_cast<const float*>(p)); }
+    SRLZ_AVX2 static vector_type set(const float v) noexcept { return _mm256_set1_ps(v); }
+    SRLZ_AVX2 static vector_type equal(vector_type a, vector_type b) noexcept { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    SRLZ_AVX2 static vector_type less(vector_type a, vector_type b) noexcept { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    SRLZ_AVX2 static vector_type greater(vector_type a, vector_type b) noexcept { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    SRLZ_AVX2 static vector_type both(vector_type a, vector_type b) noexcept { return _mm256_and_ps(a, b); }
+    SRLZ_AVX2 static vector_type not_less(vector_type a, vector_type b) noexcept { return _mm256_cmp_ps(a, b, _CMP_NLT_UQ); }
+    SRLZ_AVX2 static vector_type not_greater(vector_type a, vector_type b) noexcept { return _mm256_cmp_ps(a, b, _CMP_NGT_UQ); }
+    SRLZ_AVX2 static unsigned bits(vector_type a) noexcept { return unsigned(_mm256_movemask_ps(a)); }
+};
+
+template<>
+struct avx2_ops<double>
+{
+    using vector_type = __m256d;
+    static constexpr size_t lanes = 4;
+
+    SRLZ_AVX2 static vector_type load(const char* p) noexcept { return _mm256_loadu_pd(reinterpret_cast<const double*>(p)); }
+    SRLZ_AVX2 static vector_type set(const double v) noexcept { return _mm256_set1_pd(v); }
+    SRLZ_AVX2 static vector_type equal(vector_type a, vector_type b) noexcept { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+    SRLZ_AVX2 static vector_type less(vector_type a, vector_type b) noexcept { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    SRLZ_AVX2 static vector_type greater(vector_type a, vector_type b) noexcept { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    SRLZ_AVX2 static vector_type both(vector_type a, vector_type b) noexcept { return _mm256_and_pd(a, b); }
+    SRLZ_AVX2 static vector_type not_less(vector_type a, vector_type b) noexcept { return _mm256_cmp_pd(a, b, _CMP_NLT_UQ); }
+    SRLZ_AVX2 static vector_type not_greater(vector_type a, vector_type b) noexcept { return _mm256_cmp_pd(a, b, _CMP_NGT_UQ); }
+    SRLZ_AVX2 static unsigned bits(vector_type a) noexcept { return unsigned(_mm256_movemask_pd(a)); }
+};
+
+/**
+ * @brief one block of lanes, shared by both instruction sets through the ops,
+ * a RANGE fails on NaN like the scalar predicate
+ */
+#define SRLZ_SCAN_BLOCK(ops) \
+    const auto value = ops::load(column.get_values() + index * sizeof(T)); \
+    typename ops::vector_type mask; \
+    switch (condition.kind) \
+    { \
+    case predicate_kind::EQUAL   : mask = ops::equal(value, low); break; \
+    case predicate_kind::LESS    : mask = ops::less(value, low); break; \
+    case predicate_kind::GREATER : mask = ops::greater(value, low); break; \
+    case predicate_kind::RANGE   : \
+        if constexpr (std::is_integral_v<T>) \
+            mask = ops::neither(ops::less(value, low), ops::greater(value, high)); \
+        else \
+            mask = ops::both(ops::both(ops::not_less(value, low), ops::not_greater(value, high)), ops::equal(value, value)); \
+        break; \
+    default: \
+        if constexpr (std::is_integral_v<T>) \
+            mask = ops::any_bits(value, low); \
+        else \
+            mask = ops::less(value, value); \
+        break; \
+    } \
+    emit(ops::bits(mask) & presence_bits(column.get_presence(), index, ops::lanes), index, matches);
+// SRLZ_SCAN_BLOCK
+
+template<typename T>
+size_t sse2_scan(const column_view<T>& column, const predicate<T>& condition, std::vector<size_t>& matches)
+{
+    using ops = sse2_ops<T>;
+
+    const auto low = ops::set(condition.low);
+    const auto high = ops::set(condition.high);
+    size_t index = 0;
+
+    for (; index + ops::lanes <= column.size(); index += ops::lanes)
+    {
+        SRLZ_SCAN_BLOCK(ops)
+    }
+
+    return index;
+}
+
+template<typename T>
+SRLZ_AVX2 size_t avx2_scan(const column_view<T>& column, const predicate<T>& condition, std::vector<size_t>& matches)
+{
+    using ops = avx2_ops<T>;
+
+    const auto low = ops::set(condition.low);
+    const auto high = ops::set(condition.high);
+    size_t index = 0;
+
+    for (; index + ops::lanes <= column.size(); index += ops::lanes)
+    {
+        SRLZ_SCAN_BLOCK(ops)
+    }
+
+    return index;
+}
+
+#undef SRLZ_SCAN_BLOCK
+
+template<typename T>
+constexpr bool has_sse2_kernel = std::is_same_v<T, int32_t> || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+template<typename T>
+constexpr bool has_avx2_kernel = has_sse2_kernel<T> || std::is_same_v<T, int64_t>;
+
+#undef SRLZ_AVX2
+
+#endif // SRLZ_SCAN_X86
+
+} // namespace scan_detail
+
+/**
+ * @brief appends the indices of present values which satisfy the condition, returns how many were appended,
+ * int32_t, int64_t, float and double columns use the widest kernels up to max_isa, other types are scanned by scalar code
+ */
+template<typename T>
+size_t scan(
+    const column_view<T>& column,
+    const predicate<T>& condition,
+    std::vector<size_t>& matches,
+    const scan_isa max_isa = scan_isa::AVX2
+    )
+{
+    const size_t initial = matches.size();
+    size_t done = 0;
+
+#ifdef SRLZ_SCAN_X86
+    const scan_isa isa = max_isa < detect_scan_isa() ? max_isa : detect_scan_isa();
+
+    if constexpr (scan_detail::has_avx2_kernel<T>)
+        if (isa == scan_isa::AVX2)
+            done = scan_detail::avx2_scan(column, condition, matches);
+
+    if constexpr (scan_detail::has_sse2_kernel<T>)
+        if (isa == scan_isa::SSE2)
+            done = scan_detail::sse2_scan(column, condition, matches);
+#else
+    (void)max_isa;
+#endif
+
+    scan_detail::scalar_scan(column, condition, done, matches);
+
+    return matches.size() - initial;
+}
+
+} // namespace srlz
+
+#endif // SRLZ_SCAN_HPP
@@ -0,0 +1,132 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_SEQLOCK_HPP
+#define SRLZ_SEQLOCK_HPP
+
+#include <atomic>
+#include <thread>
+
+#include "base.hpp"
+#include "max_serialized_size.hpp"
+
+namespace srlz
+{
+
+/**
+ * @brief fixed layout entity shared by one writer thread and any number of reader threads without locks,
+ * the writer changes the entity inside update() or between begin_write() and end_write(),
+ * serialize retries until it has copied a snapshot no write overlapped with,
+ * deserialize counts as a write
+ */
+template<typename _Entity>
+class seqlock final : public base
+{
+    static_assert(has_max_serialized_size<_Entity>::value, "seqlock needs an entity of fixed layout");
+
+public:
+    static constexpr size_t max_serialized_size = _Entity::max_serialized_size;
+
+    virtual ~seqlock() = default;
+
+    /**
+     * @brief for the writer thread only
+     */
+    template<typename F>
+    void update(F&& f)
+    {
+        begin_write();
+        f(entity);
+        end_write();
+    }
+
+    /**
+     * @brief for the writer thread only
+     */
+    void begin_write() noexcept
+    {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    /**
+     * @brief for the writer thread only
+     */
+    void end_write() noexcept
+    {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief for the writer thread only, changes have to happen between begin_write() and end_write()
+     */
+    _Entity& get_unsafe() noexcept
+    {
+        return entity;
+    }
+
+    /**
+     * @brief for the writer thread only
+     */
+    const _Entity& get() const noexcept
+    {
+        return entity;
+    }
+
+    virtual bool serialize(
+        char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const override
+    {
+        assert_max_serialized_size(entity);
+
+        const size_t start_offset = buffer_offset;
+
+        while (true)
+        {
+            const size_t before = sequence.load(std::memory_order_acquire);
+
+            if (before & 1)
+            {
+                std::this_thread::yield();
+
+                continue;
+            }
+
+            buffer_offset = start_offset;
+            const bool success = entity.serialize(buffer, buffer_size, buffer_offset);
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (sequence.load(std::memory_order_relaxed) == before)
+                return success;
+        }
+    }
+
+    virtual bool deserialize(
+        const char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const override
+    {
+        auto& self = const_cast<seqlock&>(*this);
+
+        self.begin_write();
+        const bool success = entity.deserialize(buffer, buffer_size, buffer_offset);
+        self.end_write();
+
+        return success;
+    }
+
+private:
+    _Entity entity;
+    std::atomic<size_t> sequence = 0;
+};
+
+} // namespace srlz
+
+#endif // SRLZ_SEQLOCK_HPP
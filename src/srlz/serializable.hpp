@@ -8,19 +8,28 @@
 #ifndef SRLZ_SERIALIZABLE_HPP
 #define SRLZ_SERIALIZABLE_HPP
 
+#include <atomic>
 #include <cassert>
 #include <cstring>
+#include <memory>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 
 #include "member.hpp"
 #include "memory.h"
 #include "base.hpp"
+#include "dictionary.hpp"
+#include "plan.hpp"
 
 namespace srlz
 {
 
 class serializable : public base
 {
+    template<typename _Tp>
+    friend class mapped_store;
+
 public:
     using member_vector_type = const std::vector<void*>;
 
@@ -80,27 +89,535 @@ public:
 
 #undef SRLZ_COPY_FUNDAMENTAL_TYPE
 
+        invalidate();
+
+        return *this;
+    }
+
+    /**
+     * @brief steals the storage of every member, including nested ones, by swapping it with other,
+     * the members of this entity live in the derived class, so it is move constructed like srlz::variant,
+     * entity(entity&& other) : entity() { serializable::operator=(std::move(other)); },
+     * which allocates the members first and thus is not noexcept
+     */
+    serializable& operator=(serializable&& other) noexcept
+    {
+        for (size_t i = 0; i < member_vector.size(); ++i)
+        {
+            auto& common = *static_cast<member<int8_t, member_type::COMMON>*>(member_vector[i]);
+            auto& common_other = *static_cast<member<int8_t, member_type::COMMON>*>(other.member_vector[i]);
+
+            common.swap(common_other);
+        }
+
+        // nested entities changed hands
+        if (is_tracking() || other.is_tracking())
+        {
+            track();
+            other.track();
+        }
+
+        invalidate();
+        other.invalidate();
+
         return *this;
     }
 
+    /**
+     * @brief keeps the serialized bytes of this entity until a member changes,
+     * set, set_has_value and get_unsafe of a member invalidate the cache, as well as the same calls on nested entities
+     * and on the elements of containers, which are linked whenever the cache is filled and only invalidate their parent,
+     * a nested entity keeps bytes of its own only if its cache is enabled as well,
+     * so elements have to be inserted and removed through get_unsafe, a container reference kept from an earlier call is not tracked,
+     * the cache is filled without synchronization, so serialize a shared entity once before other threads do,
+     * the cache is bypassed in a canonical_scope and a dictionary_scope
+     */
+    void enable_cache()
+    {
+        if (!cache.data)
+            cache.data = std::make_unique<cache_data>();
+
+        cache.data->enabled = true;
+        cache.data->bytes.reset();
+        track();
+    }
+
+    /**
+     * @brief drops the cached bytes, an entity nested in a cached one still invalidates its parent
+     */
+    void disable_cache()
+    {
+        if (cache.data && cache.data->presence)
+        {
+            cache.data->enabled = false;
+            cache.data->bytes.reset();
+        }
+        else
+            cache.data.reset();
+
+        track();
+    }
+
+    bool is_cache_enabled() const noexcept
+    {
+        return cache.data && cache.data->enabled;
+    }
+
+    bool is_cached() const noexcept
+    {
+        return cache.data && cache.data->bytes;
+    }
+
+    /**
+     * @brief true if the class of this entity writes more than its members, such an entity is gathered and encoded
+     * through serialize, a class which overrides serialize with another format has to override this as well
+     */
+    virtual bool overrides_serialize() const noexcept
+    {
+        return false;
+    }
+
+    /**
+     * @brief gives this entity the plan of class T, which is looked up once per class,
+     * only for an entity whose dynamic type is T, such as an element created by a container
+     */
+    template<class T>
+    void use_class_plan() const
+    {
+        static const serialization_plan* const plan = &get_plan();
+
+        cache.plan.store(plan, std::memory_order_release);
+    }
+
+    /**
+     * @brief drops the cached bytes of this entity and of the entities it is nested in,
+     * a record of a mapped_store writes has_value of its members to the file as well
+     */
+    void invalidate() const noexcept
+    {
+        if (cache.data && cache.data->presence)
+            write_presence();
+
+        for (const serializable* entity = this; entity; entity = entity->cache.parent)
+            if (entity->cache.data)
+                entity->cache.data->bytes.reset();
+    }
+
+    /**
+     * @brief the serialized bytes, filled if needed, they stay valid for the holder after the entity changes,
+     * nullptr if the cache is disabled, the entity cannot be serialized, a scope is active or serialize is overridden
+     */
+    std::shared_ptr<const std::vector<char>> get_cached() const
+    {
+        if (!is_cache_enabled() || bypass_cache() || overrides_serialize())
+            return nullptr;
+
+        auto& bytes = cache.data->bytes;
+
+        if (!bytes)
+        {
+            std::vector<char> temporary(64);
+            size_t offset;
+
+            link_members();
+
+            while (!serialize_members(temporary.data(), temporary.size(), offset = 0))
+            {
+                if (temporary.size() >= max_gather_fallback_size)
+                    return nullptr;
+
+                temporary.resize(temporary.size() * 2);
+            }
+
+            temporary.resize(offset);
+            bytes = std::make_shared<const std::vector<char>>(std::move(temporary));
+        }
+
+        return bytes;
+    }
+
+    struct member_view
+    {
+        member_type type;
+        bool* has_value;
+        void* value;
+    };
+
+    size_t get_member_count() const noexcept
+    {
+        return member_vector.size();
+    }
+
+    /**
+     * @brief raw access to a member for batch codecs, value points to the fundamental value or to the srlz object
+     */
+    member_view get_member(const size_t index) const noexcept
+    {
+        auto& common = *static_cast<member<int8_t, member_type::COMMON>*>(member_vector[index]);
+
+        return { common.get_type(), &common.has_value_, static_cast<void*>(common.value_.get()) };
+    }
+
+    /**
+     * @brief the value of a member, which is allocated even without a value, and the heap memory it owns
+     */
+    footprint get_member_footprint(const size_t index) const
+    {
+        auto& common = *static_cast<const member<int8_t, member_type::COMMON>*>(member_vector[index]);
+        footprint result { 1, common.size_ };
+
+        if (common.get_type() == member_type::SRLZ)
+            result += static_cast<const base*>(static_cast<const void*>(common.value_.get()))->get_footprint();
+
+        return result;
+    }
+
+    /**
+     * @brief all members, the cache and the cached bytes
+     */
+    virtual footprint get_footprint() const override
+    {
+        footprint result;
+
+        for (size_t i = 0; i < member_vector.size(); ++i)
+            result += get_member_footprint(i);
+
+        if (cache.data)
+            result += { 1, sizeof(cache_data) };
+
+        if (is_cached())
+            result += { 2, sizeof(std::vector<char>) + cache.data->bytes->capacity() };
+
+        return result;
+    }
+
+    /**
+     * @brief every member with its has_value flag, variable_size if a member or serialize of the class is not fixed
+     */
+    virtual size_t get_max_size() const noexcept override
+    {
+        if (overrides_serialize())
+            return variable_size;
+
+        size_t result = 0;
+
+        for (auto memb : member_vector)
+        {
+            const auto& common = *static_cast<const member<int8_t, member_type::COMMON>*>(memb);
+            const size_t size = common.get_type() == member_type::SRLZ
+                ? static_cast<const base*>(static_cast<const void*>(common.value_.get()))->get_max_size()
+                : fundamental_size(common.get_type());
+
+            if (size == variable_size)
+                return variable_size;
+
+            result += sizeof(bool) + size;
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief the types of the members in order, srlz members are described recursively
+     */
+    virtual void describe_layout(xxh64& hash) const override
+    {
+        describe(hash, overrides_serialize() ? layout_tag::CUSTOM_ENTITY : layout_tag::ENTITY);
+
+        for (size_t i = 0; i < member_vector.size(); ++i)
+        {
+            const auto member = get_member(i);
+
+            hash.update(&member.type, sizeof(member.type));
+
+            if (member.type == member_type::SRLZ)
+                static_cast<const base*>(member.value)->describe_layout(hash);
+        }
+
+        describe(hash, layout_tag::END);
+    }
+
+    /**
+     * @brief makes a change of this entity invalidate the cache of parent, the own cache of this entity is left as it is
+     */
+    virtual void link_entities(const serializable* const parent) const override
+    {
+        cache.parent = parent;
+        track();
+    }
+
     virtual bool serialize(
         char* const buffer,
         const size_t buffer_size,
         size_t& buffer_offset
         ) const override
     {
+        if (!is_cache_enabled() || bypass_cache())
+            return serialize_members(buffer, buffer_size, buffer_offset);
+
+        auto& bytes = cache.data->bytes;
+
+        if (bytes)
+            return write(static_cast<const void*>(bytes->data()), bytes->size(), buffer, buffer_size, buffer_offset);
+
+        link_members();
+
+        const size_t start = buffer_offset;
+
+        if (!serialize_members(buffer, buffer_size, buffer_offset))
+            return false;
+
+        bytes = std::make_shared<const std::vector<char>>(buffer + start, buffer + buffer_offset);
+
+        return true;
+    }
+
+    /**
+     * @brief a cached entity is referenced as one range, which is valid until the entity changes,
+     * an entity whose class overrides serialize is gathered through serialize
+     */
+    virtual bool gather(iovec_list& list) const override
+    {
+        if (overrides_serialize())
+            return base::gather(list);
+
+        if (is_cache_enabled() && !bypass_cache())
+        {
+            const auto bytes = get_cached();
+
+            if (!bytes)
+                return false;
+
+            list.append(static_cast<const void*>(bytes->data()), bytes->size());
+
+            return true;
+        }
+
+        return gather_members(list);
+    }
+
+    virtual bool deserialize(
+        const char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const override
+    {
+        const bool success = deserialize_members(buffer, buffer_size, buffer_offset);
+
+        invalidate();
+
+        return success;
+    }
+
+private:
+    /**
+     * @brief allocated by enable_cache() or by a mapped_store for its records, whose has_value bytes live in the file
+     */
+    struct cache_data
+    {
+        bool enabled = false;
+        std::shared_ptr<const std::vector<char>> bytes;
+        char* presence = nullptr;
+    };
+
+    /**
+     * @brief state of the cache, which is not copied with the entity, the parent is kept by an entity nested in a cached one
+     * and the plan by every element of a container, so they stay inline and only an enabled cache is allocated
+     */
+    struct cache_state
+    {
+        cache_state() = default;
+        cache_state(const cache_state&) noexcept {}
+
+        cache_state& operator=(const cache_state&) noexcept
+        {
+            return *this;
+        }
+
+        const serializable* parent = nullptr;
+        std::unique_ptr<cache_data> data;
+        std::atomic<const serialization_plan*> plan { nullptr };
+    };
+
+    /**
+     * @brief keeps has_value of member i in presence[i] from now on, used by mapped_store
+     */
+    void map_presence(char* const presence) const
+    {
+        if (!cache.data)
+            cache.data = std::make_unique<cache_data>();
+
+        cache.data->presence = presence;
+        track();
+        write_presence();
+    }
+
+    void write_presence() const noexcept
+    {
+        for (size_t i = 0; i < member_vector.size(); ++i)
+            cache.data->presence[i] = static_cast<const member<int8_t, member_type::COMMON>*>(member_vector[i])->has_value_;
+    }
+
+    static bool bypass_cache() noexcept
+    {
+        return canonical_scope::get() || dictionary_scope::get();
+    }
+
+    /**
+     * @brief true if a change has to invalidate a cache, the one of this entity or the one of an entity it is nested in
+     */
+    bool is_tracking() const noexcept
+    {
+        return cache.data || cache.parent;
+    }
+
+    /**
+     * @brief points the members at this entity and the entities stored in them at their parent while changes are tracked
+     */
+    void track() const
+    {
+        const bool tracking = is_tracking();
+
+        for (auto memb : member_vector)
+            static_cast<member<int8_t, member_type::COMMON>*>(memb)->owner_ = tracking ? this : nullptr;
+
+        link_members();
+    }
+
+    /**
+     * @brief points the entities stored in srlz members at this entity,
+     * called again before the cache is filled, since containers may have got new elements
+     */
+    void link_members() const
+    {
+        const serializable* const parent = is_tracking() ? this : nullptr;
+
+        for (auto memb : member_vector)
+        {
+            const auto& common = *static_cast<const member<int8_t, member_type::COMMON>*>(memb);
+
+            if (common.get_type() == member_type::SRLZ)
+                static_cast<const base*>(static_cast<const void*>(common.value_.get()))->link_entities(parent);
+        }
+    }
+
+    /**
+     * @brief the plan of the class of this entity, the members of a class are the same in every instance,
+     * it is looked up once per instance unless the creator of the entity gave it the plan of its class
+     */
+    const serialization_plan& get_plan() const
+    {
+        if (const serialization_plan* const plan = cache.plan.load(std::memory_order_acquire))
+            return *plan;
+
+        const std::type_info& type = typeid(*this);
+        const serialization_plan* plan = serialization_plan::find(type);
+
+        if (!plan)
+        {
+            serialization_plan built;
+
+            for (size_t i = 0; i < member_vector.size(); ++i)
+            {
+                auto& common = *static_cast<const member<int8_t, member_type::COMMON>*>(member_vector[i]);
+
+                built.append(uint32_t(i), fundamental_size(common.get_type()));
+            }
+
+            plan = &serialization_plan::add(type, std::move(built));
+        }
+
+        cache.plan.store(plan, std::memory_order_release);
+
+        return *plan;
+    }
+
+    /**
+     * @brief copies a value of a fundamental size, which is known to the compiler in every branch
+     */
+    static void copy_value(void* const destination, const void* const source, const size_t size) noexcept
+    {
+        switch (size)
+        {
+        case 1  : std::memcpy(destination, source, 1); break;
+        case 2  : std::memcpy(destination, source, 2); break;
+        case 4  : std::memcpy(destination, source, 4); break;
+        case 8  : std::memcpy(destination, source, 8); break;
+        default : std::memcpy(destination, source, size); break;
+        }
+    }
+
+    bool serialize_members(
+        char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const
+    {
+        canonical_scope* const canonical = canonical_scope::get();
+        const serialization_plan& plan = get_plan();
+
+        for (const auto& run : plan.runs)
+        {
+            if (run.max_size == 0 || canonical || buffer_offset > buffer_size || run.max_size > buffer_size - buffer_offset)
+            {
+                if (!serialize_range(run.first, run.first + run.count, canonical, buffer, buffer_size, buffer_offset))
+                    return false;
+
+                continue;
+            }
+
+            char* output = buffer + buffer_offset;
+
+            for (size_t i = run.first; i < run.first + run.count; ++i)
+            {
+                auto& common = *static_cast<const member<int8_t, member_type::COMMON>*>(member_vector[i]);
+
+                std::memcpy(output, &common.has_value_, sizeof(bool));
+                output += sizeof(bool);
+
+                if (!common.has_value_)
+                    continue;
+
+                copy_value(output, common.value_.get(), plan.sizes[i]);
+                output += plan.sizes[i];
+            }
+
+            buffer_offset = size_t(output - buffer);
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief serializes the members [first, last) one by one with all the checks
+     */
+    bool serialize_range(
+        const size_t first,
+        const size_t last,
+        canonical_scope* const canonical,
+        char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const
+    {
 
 #define SRLZ_SERIALIZE_FUNDAMENTAL_TYPE(T, member_type) \
     auto& mem = *static_cast<const member<T, member_type>*>(memb); \
-    if (!write(static_cast<const void* const>(mem.value_.get()), sizeof(*mem.value_.get()), buffer, buffer_size, buffer_offset)) \
+    const void* const value = canonical \
+        ? canonical_scope::normalize(member_type, mem.value_.get(), temporary) \
+        : static_cast<const void*>(mem.value_.get()); \
+    if (!write(value, sizeof(*mem.value_.get()), buffer, buffer_size, buffer_offset)) \
         return false;
 // SRLZ_SERIALIZE_FUNDAMENTAL_TYPE
 
-        for (auto memb : member_vector)
+        unsigned char temporary[sizeof(long double)];
+
+        for (size_t i = first; i < last; ++i)
         {
+            auto memb = member_vector[i];
             auto& common = *static_cast<const member<int8_t, member_type::COMMON>*>(memb);
 
-            if (!write(static_cast<const void* const>(&common.has_value_), sizeof(bool), buffer, buffer_size, buffer_offset))
+            if (!write(static_cast<const void*>(&common.has_value_), sizeof(bool), buffer, buffer_size, buffer_offset))
                 return false;
 
             if (!common.has_value_)
@@ -143,23 +660,115 @@ public:
         return true;
     }
 
-    virtual bool deserialize(
+    bool gather_members(iovec_list& list) const
+    {
+        canonical_scope* const canonical = canonical_scope::get();
+        unsigned char temporary[sizeof(long double)];
+
+        for (auto memb : member_vector)
+        {
+            auto& common = *static_cast<const member<int8_t, member_type::COMMON>*>(memb);
+
+            list.copy(static_cast<const void*>(&common.has_value_), sizeof(bool));
+
+            if (!common.has_value_)
+                continue;
+
+            if (common.get_type() == member_type::SRLZ)
+            {
+                auto& mem = *static_cast<const member<serializable, member_type::SRLZ>*>(memb);
+
+                if (!mem.value_->gather(list))
+                    return false;
+
+                continue;
+            }
+
+            const size_t size = fundamental_size(common.get_type());
+
+            if (size == 0)
+            {
+                assert(false);
+
+                return false;
+            }
+
+            const void* const value = static_cast<const void*>(common.value_.get());
+
+            list.copy(canonical ? canonical_scope::normalize(common.get_type(), value, temporary) : value, size);
+        }
+
+        return true;
+    }
+
+    bool deserialize_members(
         const char* const buffer,
         const size_t buffer_size,
         size_t& buffer_offset
-        ) const override
+        ) const
+    {
+        limits_scope::depth_guard depth;
+
+        if (!depth)
+            return false;
+
+        const serialization_plan& plan = get_plan();
+
+        for (const auto& run : plan.runs)
+        {
+            if (run.max_size == 0 || buffer_offset > buffer_size || run.max_size > buffer_size - buffer_offset)
+            {
+                if (!deserialize_range(run.first, run.first + run.count, buffer, buffer_size, buffer_offset))
+                    return false;
+
+                continue;
+            }
+
+            const char* input = buffer + buffer_offset;
+
+            for (size_t i = run.first; i < run.first + run.count; ++i)
+            {
+                auto& common = *static_cast<member<int8_t, member_type::COMMON>*>(member_vector[i]);
+
+                std::memcpy(&common.has_value_, input, sizeof(bool));
+                input += sizeof(bool);
+
+                if (!common.has_value_)
+                    continue;
+
+                copy_value(common.value_.get(), input, plan.sizes[i]);
+                input += plan.sizes[i];
+            }
+
+            buffer_offset = size_t(input - buffer);
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief deserializes the members [first, last) one by one with all the checks
+     */
+    bool deserialize_range(
+        const size_t first,
+        const size_t last,
+        const char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const
     {
 
 #define SRLZ_DESERIALIZE_FUNDAMENTAL_TYPE(T, member_type) \
     auto& mem = *static_cast<const member<T, member_type>*>(memb); \
-    if (!read(static_cast<void* const>(mem.value_.get()), sizeof(*mem.value_.get()), buffer, buffer_size, buffer_offset)) \
+    if (!read(static_cast<void*>(mem.value_.get()), sizeof(*mem.value_.get()), buffer, buffer_size, buffer_offset)) \
         return false;
 // SRLZ_DESERIALIZE_FUNDAMENTAL_TYPE
 
-        for (auto memb : member_vector)
+        for (size_t i = first; i < last; ++i)
         {
+            auto memb = member_vector[i];
             auto& common = *static_cast<member<int8_t, member_type::COMMON>*>(memb);
-            if (!read(static_cast<void* const>(&common.has_value_), sizeof(bool), buffer, buffer_size, buffer_offset))
+            if (!read(static_cast<void*>(&common.has_value_), sizeof(bool), buffer, buffer_size, buffer_offset))
                 return false;
 
             if (!common.has_value_)
@@ -202,10 +811,15 @@ public:
         return true;
     }
 
-private:
     member_vector_type& member_vector;
+    mutable cache_state cache;
 };
 
+inline void invalidate_cache(const serializable* owner) noexcept
+{
+    owner->invalidate();
+}
+
 } // namespace srlz
 
 #endif // SRLZ_SERIALIZABLE_HPP
@@ -0,0 +1,308 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_SHM_CHANNEL_HPP
+#define SRLZ_SHM_CHANNEL_HPP
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "ring.hpp"
+
+namespace srlz
+{
+
+/**
+ * @brief ring of serialized messages in a POSIX shared memory segment for processes on one host,
+ * senders serialize straight into the segment, the receiver deserializes or reads views straight from it,
+ * blocked senders and receivers sleep on futexes in the segment
+ */
+template<producer_mode pm = producer_mode::SINGLE>
+class shm_channel final
+{
+public:
+    /**
+     * @brief creates the segment, nullptr if it exists or cannot be created, the creator unlinks it on destruction
+     */
+    static std::unique_ptr<shm_channel> create(const char* const name, const size_t capacity)
+    {
+        const int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+
+        if (fd < 0)
+            return nullptr;
+
+        const size_t size = sizeof(segment_header) + ring<pm>::required_size(capacity);
+
+        if (ftruncate(fd, off_t(size)) != 0)
+        {
+            close(fd);
+            shm_unlink(name);
+
+            return nullptr;
+        }
+
+        std::unique_ptr<shm_channel> channel(new shm_channel(name, fd, size, capacity, true));
+
+        if (!channel->header)
+            return nullptr;
+
+        // the magic is published last so that an opener never sees a half initialized segment
+        channel->header->magic.store(segment_magic, std::memory_order_release);
+
+        return channel;
+    }
+
+    /**
+     * @brief opens a segment made by create(), nullptr if it does not exist or is not initialized yet
+     */
+    static std::unique_ptr<shm_channel> open(const char* const name)
+    {
+        const int fd = shm_open(name, O_RDWR, 0);
+
+        if (fd < 0)
+            return nullptr;
+
+        struct stat status;
+
+        if (fstat(fd, &status) != 0 || size_t(status.st_size) < sizeof(segment_header))
+        {
+            close(fd);
+
+            return nullptr;
+        }
+
+        const size_t size = size_t(status.st_size);
+        std::unique_ptr<shm_channel> channel(new shm_channel(nullptr, fd, size, size - sizeof(segment_header) - ring<pm>::required_size(0), false));
+
+        if (!channel->header || channel->header->magic.load(std::memory_order_acquire) != segment_magic)
+            return nullptr;
+
+        return channel;
+    }
+
+    ~shm_channel()
+    {
+        channel.reset();
+
+        if (header)
+            munmap(static_cast<void*>(header), size);
+
+        if (fd >= 0)
+            close(fd);
+
+        if (owner)
+            shm_unlink(name.c_str());
+    }
+
+    bool try_send(const base& message, const size_t max_size)
+    {
+        if (!channel->try_push(message, max_size))
+        {
+            // the end of the ring may have been skipped, which the receiver has to pass
+            notify(header->data_sequence, header->data_waiters);
+
+            return false;
+        }
+
+        notify(header->data_sequence, header->data_waiters);
+
+        return true;
+    }
+
+    template<typename T>
+    bool try_send(const T& message)
+    {
+        assert_max_serialized_size(message);
+
+        return try_send(message, T::max_serialized_size);
+    }
+
+    /**
+     * @brief waits while the ring is full, false if the message does not fit max_size
+     */
+    bool send(const base& message, const size_t max_size)
+    {
+        while (true)
+        {
+            const uint32_t sequence = header->space_sequence.load();
+            auto slot = channel->try_reserve(max_size);
+
+            if (!slot.data)
+            {
+                if (!channel->fits(max_size))
+                    return false;
+
+                notify(header->data_sequence, header->data_waiters);
+                wait(header->space_sequence, header->space_waiters, sequence);
+
+                continue;
+            }
+
+            size_t offset = 0;
+            const bool success = message.serialize(slot.data, slot.size, offset);
+            channel->commit(slot, success ? offset : 0, !success);
+            notify(header->data_sequence, header->data_waiters);
+
+            return success;
+        }
+    }
+
+    template<typename T>
+    bool send(const T& message)
+    {
+        assert_max_serialized_size(message);
+
+        return send(message, T::max_serialized_size);
+    }
+
+    /**
+     * @brief the oldest message or an empty view, valid until release()
+     */
+    typename ring<pm>::view peek() noexcept
+    {
+        const uint64_t released = channel->released();
+        const auto view = channel->peek();
+
+        // a skipped end of the ring frees space for a sender
+        if (channel->released() != released)
+            notify(header->space_sequence, header->space_waiters);
+
+        return view;
+    }
+
+    /**
+     * @brief waits for a message, the view is valid until release()
+     */
+    typename ring<pm>::view wait_peek() noexcept
+    {
+        while (true)
+        {
+            const uint32_t sequence = header->data_sequence.load();
+            auto view = peek();
+
+            if (view.data)
+                return view;
+
+            wait(header->data_sequence, header->data_waiters, sequence);
+        }
+    }
+
+    void release() noexcept
+    {
+        channel->release();
+        notify(header->space_sequence, header->space_waiters);
+    }
+
+    bool try_receive(const base& message)
+    {
+        return receive(message, peek());
+    }
+
+    /**
+     * @brief waits for a message and deserializes it
+     */
+    bool receive(const base& message)
+    {
+        return receive(message, wait_peek());
+    }
+
+private:
+    struct segment_header
+    {
+        std::atomic<uint64_t> magic;
+        alignas(64) std::atomic<uint32_t> data_sequence;
+        std::atomic<uint32_t> data_waiters;
+        alignas(64) std::atomic<uint32_t> space_sequence;
+        std::atomic<uint32_t> space_waiters;
+    };
+
+    static_assert(sizeof(segment_header) % 64 == 0);
+    static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+    static constexpr uint64_t segment_magic = 0x73726c7a73686d31;
+
+    shm_channel(const char* const name, const int fd, const size_t size, const size_t capacity, const bool owner)
+        : fd(fd), size(size), owner(owner), name(owner ? name : "")
+    {
+        void* const memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if (memory == MAP_FAILED)
+            return;
+
+        header = static_cast<segment_header*>(memory);
+
+        if (owner)
+            new (header) segment_header{};
+
+        channel = std::make_unique<ring<pm>>(static_cast<char*>(memory) + sizeof(segment_header), capacity, owner);
+    }
+
+    bool receive(const base& message, const typename ring<pm>::view view)
+    {
+        if (!view.data)
+            return false;
+
+        size_t offset = 0;
+        const bool success = message.deserialize(view.data, view.size, offset);
+        release();
+
+        return success;
+    }
+
+    static void notify(std::atomic<uint32_t>& sequence, std::atomic<uint32_t>& waiters) noexcept
+    {
+        sequence.fetch_add(1);
+
+        if (waiters.load() == 0)
+            return;
+
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&sequence), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+    }
+
+    static void wait(std::atomic<uint32_t>& sequence, std::atomic<uint32_t>& waiters, const uint32_t expected) noexcept
+    {
+        waiters.fetch_add(1);
+
+#ifdef __linux__
+        if (sequence.load() == expected)
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&sequence), FUTEX_WAIT, expected, nullptr, nullptr, 0);
+#else
+        while (sequence.load() == expected)
+            std::this_thread::yield();
+#endif
+
+        waiters.fetch_sub(1);
+    }
+
+    int fd;
+    size_t size;
+    bool owner;
+    std::string name;
+    segment_header* header = nullptr;
+    std::unique_ptr<ring<pm>> channel;
+};
+
+} // namespace srlz
+
+#endif // SRLZ_SHM_CHANNEL_HPP
@@ -0,0 +1,177 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_STATIC_SERIALIZABLE_HPP
+#define SRLZ_STATIC_SERIALIZABLE_HPP
+
+#include <cassert>
+#include <tuple>
+
+#include "max_serialized_size.hpp"
+#include "serializable.hpp"
+
+namespace srlz
+{
+
+/**
+ * @brief serializable whose members are also listed at compile time, _Derived defines
+ * static constexpr auto members() returning a tuple of pointers to its members in the order of member_vector,
+ * serialize and deserialize walk that tuple, so nested members and elements of a vector of a final _Derived
+ * are called directly and can be inlined, the wire format and the virtual interface stay those of serializable,
+ * a cached entity and a canonical_scope take the path of serializable
+ */
+template<class _Derived>
+class static_serializable : public serializable
+{
+public:
+    virtual ~static_serializable() = default;
+
+    static_serializable(member_vector_type& member_vector)
+        : serializable(member_vector) {}
+
+    static_serializable& operator=(const static_serializable& other)
+    {
+        serializable::operator=(other);
+
+        return *this;
+    }
+
+    static_serializable& operator=(static_serializable&& other) noexcept
+    {
+        serializable::operator=(std::move(other));
+
+        return *this;
+    }
+
+    virtual bool serialize(
+        char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const override
+    {
+        if (is_cache_enabled() || canonical_scope::get())
+            return serializable::serialize(buffer, buffer_size, buffer_offset);
+
+        assert_members();
+
+        const auto& self = static_cast<const _Derived&>(*this);
+
+        return std::apply([&](auto... pointers)
+            {
+                return (write_member(self.*pointers, buffer, buffer_size, buffer_offset) && ...);
+            }, _Derived::members());
+    }
+
+    virtual bool deserialize(
+        const char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const override
+    {
+        limits_scope::depth_guard depth;
+
+        if (!depth)
+            return false;
+
+        assert_members();
+
+        const auto& self = static_cast<const _Derived&>(*this);
+
+        const bool success = std::apply([&](auto... pointers)
+            {
+                return (read_member(self.*pointers, buffer, buffer_size, buffer_offset) && ...);
+            }, _Derived::members());
+
+        invalidate();
+
+        return success;
+    }
+
+private:
+    /**
+     * @brief asserts once per class that members() lists the members of member_vector in its order,
+     * and that a declared max_serialized_size is the one of those members
+     */
+    void assert_members() const noexcept
+    {
+#ifndef NDEBUG
+        static const bool matches = [this]
+        {
+            const auto& self = static_cast<const _Derived&>(*this);
+            size_t index = 0;
+
+            return std::tuple_size_v<decltype(_Derived::members())> == get_member_count()
+                && std::apply([&](auto... pointers)
+                    {
+                        return (member_matches(self.*pointers, index++) && ...);
+                    }, _Derived::members());
+        }();
+
+        assert(matches);
+
+        if constexpr (has_max_serialized_size<_Derived>::value)
+            assert_max_serialized_size(static_cast<const _Derived&>(*this));
+#endif
+    }
+
+    template<class T, member_type mt>
+    bool member_matches(const member<T, mt>& mem, const size_t index) const noexcept
+    {
+        const member_view view = get_member(index);
+
+        return view.type == mt && view.value == static_cast<const void*>(mem.value_.get());
+    }
+
+    /**
+     * @brief the value of a member is always of type T itself, so a qualified call is safe
+     */
+    template<class T, member_type mt>
+    bool write_member(
+        const member<T, mt>& mem,
+        char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const
+    {
+        if (!write(static_cast<const void*>(&mem.has_value_), sizeof(bool), buffer, buffer_size, buffer_offset))
+            return false;
+
+        if (!mem.has_value_)
+            return true;
+
+        if constexpr (mt == member_type::SRLZ)
+            return mem.value_->T::serialize(buffer, buffer_size, buffer_offset);
+        else
+            return write(static_cast<const void*>(mem.value_.get()), sizeof(T), buffer, buffer_size, buffer_offset);
+    }
+
+    template<class T, member_type mt>
+    bool read_member(
+        const member<T, mt>& mem,
+        const char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const
+    {
+        auto& self = const_cast<member<T, mt>&>(mem);
+
+        if (!read(static_cast<void*>(&self.has_value_), sizeof(bool), buffer, buffer_size, buffer_offset))
+            return false;
+
+        if (!self.has_value_)
+            return true;
+
+        if constexpr (mt == member_type::SRLZ)
+            return self.value_->T::deserialize(buffer, buffer_size, buffer_offset);
+        else
+            return read(static_cast<void*>(self.value_.get()), sizeof(T), buffer, buffer_size, buffer_offset);
+    }
+};
+
+} // namespace srlz
+
+#endif // SRLZ_STATIC_SERIALIZABLE_HPP
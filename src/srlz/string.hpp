@@ -8,22 +8,64 @@
 #ifndef SRLZ_STRING_HPP
 #define SRLZ_STRING_HPP
 
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 
 #include "member.hpp"
 #include "base.hpp"
+#include "dictionary.hpp"
 
 namespace srlz
 {
 
-class string : public base, public std::string
+/**
+ * @brief characters are allocated by _Alloc, a std::pmr allocator is passed on by allocator-aware containers,
+ * inside a dictionary_scope repeated values are written as references, which makes the payload smaller
+ * but still copies every value into its string on decode
+ */
+template<typename _Alloc = std::allocator<char>>
+class basic_string : public base, public std::basic_string<char, std::char_traits<char>, _Alloc>
 {
 public:
-    virtual ~string() = default;
+    /**
+     * @brief the header of an entry in a dictionary_scope, otherwise the length takes sizeof(size_t)
+     */
+    static constexpr size_t min_serialized_size = sizeof(uint32_t);
+
+    using string_type = std::basic_string<char, std::char_traits<char>, _Alloc>;
+
+    virtual ~basic_string() = default;
+    basic_string() = default;
+    explicit basic_string(const _Alloc& allocator) : string_type(allocator) {}
+    basic_string(const basic_string&) = default;
+    basic_string(basic_string&&) = default;
+    basic_string& operator=(const basic_string&) = default;
+    basic_string& operator=(basic_string&&) = default;
 
-    void set(std::string value)
+    void set(std::string_view value)
     {
-        *((std::string*)this) = value;
+        this->assign(value.data(), value.size());
+    }
+
+    /**
+     * @brief the characters unless they fit into the object itself
+     */
+    virtual footprint get_footprint() const override
+    {
+        const char* const characters = this->data();
+        const char* const self = reinterpret_cast<const char*>(this);
+
+        if (characters >= self && characters < self + sizeof(*this))
+            return {};
+
+        return { 1, this->capacity() + 1 };
+    }
+
+    virtual void describe_layout(xxh64& hash) const override
+    {
+        describe(hash, layout_tag::STRING);
     }
 
     virtual bool serialize(
@@ -32,37 +74,288 @@ public:
         size_t& buffer_offset
         ) const override
     {
+        if (auto* const scope = dictionary_scope::get())
+            return serialize_entry(*scope, buffer, buffer_size, buffer_offset);
+
         const size_t length = this->length();
 
-        if (!write(static_cast<const void* const>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
+        if (!write(static_cast<const void*>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
             return false;
 
-        if (!write(static_cast<const void* const>(c_str()), length, buffer, buffer_size, buffer_offset))
+        if (!write(static_cast<const void*>(this->c_str()), length, buffer, buffer_size, buffer_offset))
             return false;
 
         return true;
     }
 
+    virtual bool gather(iovec_list& list) const override
+    {
+        const size_t length = this->length();
+
+        if (auto* const scope = dictionary_scope::get())
+        {
+            const uint32_t header = scope->header(*this);
+
+            list.copy(static_cast<const void*>(&header), sizeof(uint32_t));
+
+            if (header & 1)
+                return true;
+
+            if (header == dictionary_scope::extended_length)
+                list.copy(static_cast<const void*>(&length), sizeof(size_t));
+
+            list.append(static_cast<const void*>(this->data()), length);
+
+            return true;
+        }
+
+        list.copy(static_cast<const void*>(&length), sizeof(size_t));
+        list.append(static_cast<const void*>(this->data()), length);
+
+        return true;
+    }
+
     virtual bool deserialize(
         const char* const buffer,
         const size_t buffer_size,
         size_t& buffer_offset
         ) const override
     {
+        if (auto* const scope = dictionary_scope::get())
+            return deserialize_entry(*scope, buffer, buffer_size, buffer_offset);
+
         size_t length;
-            
-        if (!read(static_cast<void* const>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
+
+        if (!read(static_cast<void*>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
+            return false;
+
+        if (!check_length(length, sizeof(char), buffer_size, buffer_offset) || !limits_scope::allocate(length, sizeof(char)))
+            return false;
+
+        ((string_type*)this)->resize(length);
+
+        if (!read(static_cast<void*>(((string_type*)this)->data()), length, buffer, buffer_size, buffer_offset))
+            return false;
+
+        return true;
+    }
+
+    /**
+     * @brief inside a dictionary_scope the header of the entry, the length unless it fits into the header, the characters
+     */
+    virtual std::unique_ptr<part_cursor> encode_parts() const override
+    {
+        using step = part_cursor::step;
+
+        dictionary_scope* const scope = dictionary_scope::get();
+
+        return make_cursor([this, scope, stage = scope ? 0 : 1, header = dictionary_scope::extended_length, length = this->length()](
+            size_t, value_part& part) mutable
+        {
+            if (stage == 0)
+            {
+                stage = 1;
+                header = scope->header(*this);
+                part = bytes_part(&header, sizeof(uint32_t));
+
+                return step::PART;
+            }
+
+            if (stage == 1)
+            {
+                stage = 2;
+
+                if (header & 1)
+                    return step::END;
+
+                if (header == dictionary_scope::extended_length)
+                {
+                    part = bytes_part(&length, sizeof(size_t));
+                    return step::PART;
+                }
+            }
+
+            if (stage == 2)
+            {
+                stage = 3;
+                part = bytes_part(this->data(), length);
+
+                return step::PART;
+            }
+
+            return step::END;
+        });
+    }
+
+    /**
+     * @brief the characters are read in slices, see payload_slice()
+     */
+    virtual std::unique_ptr<part_cursor> decode_parts() const override
+    {
+        using step = part_cursor::step;
+
+        dictionary_scope* const scope = dictionary_scope::get();
+
+        return make_cursor([this, scope, stage = scope ? 0 : 1, header = dictionary_scope::extended_length, length = size_t(0), received = size_t(0)](
+            size_t, value_part& part) mutable
+        {
+            auto& self = *((string_type*)this);
+
+            if (stage == 0)
+            {
+                stage = 1;
+                part = bytes_part(&header, sizeof(uint32_t));
+
+                return step::PART;
+            }
+
+            if (stage == 1)
+            {
+                stage = 2;
+
+                if (header & 1)
+                {
+                    const std::string* const entry = scope->find(header);
+
+                    if (!entry)
+                        return step::INVALID;
+
+                    self.assign(entry->data(), entry->size());
+
+                    return step::END;
+                }
+
+                if (header == dictionary_scope::extended_length)
+                {
+                    part = bytes_part(&length, sizeof(size_t));
+                    return step::PART;
+                }
+
+                length = header >> 1;
+            }
+
+            if (stage == 2)
+            {
+                stage = 3;
+
+                if (!limits_scope::allocate(length, sizeof(char)))
+                    return step::INVALID;
+
+                self.clear();
+            }
+
+            if (received < length)
+            {
+                const size_t slice = payload_slice(length, received);
+
+                self.resize(received + slice);
+                part = bytes_part(self.data() + received, slice);
+                received += slice;
+
+                return step::PART;
+            }
+
+            if (scope)
+                scope->add(self);
+
+            return step::END;
+        });
+    }
+
+private:
+    bool serialize_entry(
+        dictionary_scope& scope,
+        char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const
+    {
+        const uint32_t header = scope.header(*this);
+
+        if (!write(static_cast<const void*>(&header), sizeof(uint32_t), buffer, buffer_size, buffer_offset))
             return false;
 
-        ((std::string*)this)->resize(length);
+        if (header & 1)
+            return true;
+
+        const size_t length = this->length();
 
-        if (!read(static_cast<void* const>(((std::string*)this)->data()), length, buffer, buffer_size, buffer_offset))
+        if (header == dictionary_scope::extended_length
+            && !write(static_cast<const void*>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
             return false;
 
+        return write(static_cast<const void*>(this->data()), length, buffer, buffer_size, buffer_offset);
+    }
+
+    bool deserialize_entry(
+        dictionary_scope& scope,
+        const char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const
+    {
+        auto& self = *((string_type*)this);
+        uint32_t header;
+
+        if (!read(static_cast<void*>(&header), sizeof(uint32_t), buffer, buffer_size, buffer_offset))
+            return false;
+
+        if (header & 1)
+        {
+            const std::string* const entry = scope.find(header);
+
+            if (!entry)
+                return false;
+
+            // a copy of the entry, it reuses the capacity of the string and short entries do not allocate
+            self.assign(entry->data(), entry->size());
+
+            return true;
+        }
+
+        size_t length = header >> 1;
+
+        if (header == dictionary_scope::extended_length
+            && !read(static_cast<void*>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
+            return false;
+
+        if (!check_length(length, sizeof(char), buffer_size, buffer_offset) || !limits_scope::allocate(length, sizeof(char)))
+            return false;
+
+        self.resize(length);
+
+        if (!read(static_cast<void*>(self.data()), length, buffer, buffer_size, buffer_offset))
+            return false;
+
+        scope.add(self);
+
         return true;
     }
 };
 
+using string = basic_string<>;
+
+namespace pmr
+{
+
+using string = basic_string<std::pmr::polymorphic_allocator<char>>;
+
+} // namespace pmr
+
 } // namespace srlz
 
+namespace std
+{
+
+template<typename _Alloc>
+struct hash<srlz::basic_string<_Alloc>>
+{
+    size_t operator()(const srlz::basic_string<_Alloc>& value) const noexcept
+    {
+        return hash<std::string_view>{}(value);
+    }
+};
+
+} // namespace std
+
 #endif // SRLZ_STRING_HPP
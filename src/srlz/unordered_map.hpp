@@ -0,0 +1,233 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_UNORDERED_MAP_HPP
+#define SRLZ_UNORDERED_MAP_HPP
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "base.hpp"
+
+namespace srlz
+{
+
+enum class key_order : uint8_t
+{
+    STORED,
+    SORTED,
+};
+
+/**
+ * @brief keys are fundamental types or srlz::string, values are fundamental types or srlz types,
+ * STORED writes keys in the iteration order of the container, SORTED and a canonical_scope in ascending order
+ */
+template<typename _Key, typename _Tp, key_order ko = key_order::STORED>
+class unordered_map final : public base, public std::unordered_map<_Key, _Tp>
+{
+public:
+    static constexpr size_t min_serialized_size = sizeof(size_t);
+
+    virtual ~unordered_map() = default;
+    unordered_map() = default;
+    unordered_map(unordered_map&&) = default;
+    unordered_map& operator=(unordered_map&&) = default;
+
+    /**
+     * @brief the bucket array and a node per element, estimated as a link and a cached hash next to the key and the value
+     */
+    virtual footprint get_footprint() const override
+    {
+        footprint result { this->size(), this->size() * (sizeof(void*) + sizeof(size_t) + sizeof(typename std::unordered_map<_Key, _Tp>::value_type)) };
+
+        // a single bucket is kept inside the container
+        if (this->bucket_count() > 1)
+            result += { 1, this->bucket_count() * sizeof(void*) };
+
+        for (auto& [key, value] : *this)
+            result += footprint_of(key) + footprint_of(value);
+
+        return result;
+    }
+
+    virtual void link_entities(const serializable* const parent) const override
+    {
+        for (auto& [key, value] : *this)
+            link_item(value, parent);
+    }
+
+    virtual void describe_layout(xxh64& hash) const override
+    {
+        describe(hash, layout_tag::UNORDERED_MAP);
+        describe_item<_Key>(hash);
+        describe_item<_Tp>(hash);
+    }
+
+    virtual bool serialize(
+        char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const override
+    {
+        const size_t length = this->size();
+
+        if (!write(static_cast<const void*>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
+            return false;
+
+        if (ko == key_order::SORTED || canonical_scope::get())
+        {
+            std::vector<const typename std::unordered_map<_Key, _Tp>::value_type*> items;
+            items.reserve(length);
+
+            for (auto& item : *this)
+                items.push_back(&item);
+
+            std::sort(items.begin(), items.end(), [](auto a, auto b) { return a->first < b->first; });
+
+            for (auto item : items)
+                if (!write_pair(*item, buffer, buffer_size, buffer_offset))
+                    return false;
+        }
+        else
+        {
+            for (auto& item : *this)
+                if (!write_pair(item, buffer, buffer_size, buffer_offset))
+                    return false;
+        }
+
+        return true;
+    }
+
+    virtual bool deserialize(
+        const char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const override
+    {
+        size_t length;
+
+        if (!read(static_cast<void*>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
+            return false;
+
+        if (!check_length(length, min_item_size<_Key>() + min_item_size<_Tp>(), buffer_size, buffer_offset) || !limits_scope::allocate(length, sizeof(std::pair<const _Key, _Tp>)))
+            return false;
+
+        auto& self = *((std::unordered_map<_Key, _Tp>*)this);
+
+        self.clear();
+        self.reserve(length);
+
+        for (; length > 0; --length)
+        {
+            _Key key;
+
+            if (!read_item(key, buffer, buffer_size, buffer_offset))
+                return false;
+
+            auto it = self.try_emplace(std::move(key)).first;
+            plan_item(it->second);
+
+            if (!read_item(it->second, buffer, buffer_size, buffer_offset))
+                return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief the length, then the key and the value of every element in the order serialize writes them
+     */
+    virtual std::unique_ptr<part_cursor> encode_parts() const override
+    {
+        std::vector<const typename std::unordered_map<_Key, _Tp>::value_type*> items;
+        items.reserve(this->size());
+
+        for (auto& item : *this)
+            items.push_back(&item);
+
+        if (ko == key_order::SORTED || canonical_scope::get())
+            std::sort(items.begin(), items.end(), [](auto a, auto b) { return a->first < b->first; });
+
+        return make_cursor([length = this->size(), items = std::move(items)](const size_t index, value_part& part)
+        {
+            if (index == 0)
+                part = bytes_part(&length, sizeof(size_t));
+            else if ((index - 1) / 2 == length)
+                return part_cursor::step::END;
+            else if (index % 2 == 1)
+                part = part_of(items[index / 2]->first);
+            else
+                part = part_of(items[index / 2 - 1]->second);
+
+            return part_cursor::step::PART;
+        });
+    }
+
+    /**
+     * @brief a key is read into the cursor and moved into the map before its value is read
+     */
+    virtual std::unique_ptr<part_cursor> decode_parts() const override
+    {
+        return make_cursor([this, length = size_t(0), key = _Key()](const size_t index, value_part& part) mutable
+        {
+            using step = part_cursor::step;
+
+            auto& self = *((std::unordered_map<_Key, _Tp>*)this);
+
+            if (index == 0)
+            {
+                part = bytes_part(&length, sizeof(size_t));
+                return step::PART;
+            }
+
+            if (index == 1)
+            {
+                if (!limits_scope::allocate(length, sizeof(std::pair<const _Key, _Tp>)))
+                    return step::INVALID;
+
+                self.clear();
+                self.reserve(length);
+            }
+
+            if (index % 2 == 1)
+            {
+                if (index / 2 == length)
+                    return step::END;
+
+                key = _Key();
+                part = part_of(key);
+
+                return step::PART;
+            }
+
+            auto it = self.try_emplace(std::move(key)).first;
+            plan_item(it->second);
+            part = part_of(it->second);
+
+            return step::PART;
+        });
+    }
+
+private:
+    bool write_pair(
+        const typename std::unordered_map<_Key, _Tp>::value_type& item,
+        char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const
+    {
+        if (!write_item(item.first, buffer, buffer_size, buffer_offset))
+            return false;
+
+        return write_item(item.second, buffer, buffer_size, buffer_offset);
+    }
+};
+
+} // namespace srlz
+
+#endif // SRLZ_UNORDERED_MAP_HPP
@@ -0,0 +1,240 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_VARIANT_HPP
+#define SRLZ_VARIANT_HPP
+
+#include <array>
+#include <limits>
+#include <memory>
+#include <utility>
+
+#include "base.hpp"
+
+namespace srlz
+{
+
+/**
+ * @brief holds one of the listed srlz types, the type is written as its index in the list,
+ * by default holds a default constructed first type
+ */
+template<typename... _Types>
+class variant final : public base
+{
+    static_assert(sizeof...(_Types) > 0);
+    static_assert((std::is_base_of_v<base, _Types> && ...));
+
+public:
+    using index_type = std::conditional_t<
+        sizeof...(_Types) <= std::numeric_limits<uint8_t>::max(), uint8_t, uint16_t>;
+
+    virtual ~variant() = default;
+    variant() = default;
+
+    /**
+     * @brief the moved-from variant holds a default constructed first type
+     */
+    variant(variant&& other) : variant()
+    {
+        swap(other);
+    }
+
+    /**
+     * @brief the moved-from variant holds the previous value of this one
+     */
+    variant& operator=(variant&& other) noexcept
+    {
+        swap(other);
+
+        return *this;
+    }
+
+    void swap(variant& other) noexcept
+    {
+        std::swap(index_, other.index_);
+        value_.swap(other.value_);
+    }
+
+    size_t index() const noexcept
+    {
+        return index_;
+    }
+
+    template<typename T>
+    static constexpr size_t index_of() noexcept
+    {
+        constexpr bool matches[] = { std::is_same_v<T, _Types>... };
+
+        for (size_t i = 0; i < sizeof...(_Types); ++i)
+            if (matches[i])
+                return i;
+
+        return sizeof...(_Types);
+    }
+
+    template<typename T>
+    T& emplace()
+    {
+        static_assert(index_of<T>() < sizeof...(_Types));
+
+        value_.reset(new T);
+        index_ = index_of<T>();
+
+        return *static_cast<T*>(value_.get());
+    }
+
+    template<typename T>
+    const T* get_if() const noexcept
+    {
+        if (index_ != index_of<T>())
+            return nullptr;
+
+        return static_cast<const T*>(value_.get());
+    }
+
+    template<typename T>
+    T* get_if() noexcept
+    {
+        if (index_ != index_of<T>())
+            return nullptr;
+
+        return static_cast<T*>(value_.get());
+    }
+
+    const base& get() const noexcept
+    {
+        return *value_;
+    }
+
+    /**
+     * @brief the held value and the heap memory it owns
+     */
+    virtual footprint get_footprint() const override
+    {
+        constexpr size_t sizes[] = { sizeof(_Types)... };
+
+        return footprint{ 1, sizes[index_] } + value_->get_footprint();
+    }
+
+    virtual void link_entities(const serializable* const parent) const override
+    {
+        value_->link_entities(parent);
+    }
+
+    virtual void describe_layout(xxh64& hash) const override
+    {
+        describe(hash, layout_tag::VARIANT);
+        describe(hash, sizeof...(_Types));
+        (describe_item<_Types>(hash), ...);
+    }
+
+    virtual bool serialize(
+        char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const override
+    {
+        if (!write(static_cast<const void*>(&index_), sizeof(index_type), buffer, buffer_size, buffer_offset))
+            return false;
+
+        return value_->serialize(buffer, buffer_size, buffer_offset);
+    }
+
+    virtual bool gather(iovec_list& list) const override
+    {
+        list.copy(static_cast<const void*>(&index_), sizeof(index_type));
+
+        return value_->gather(list);
+    }
+
+    virtual bool deserialize(
+        const char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        ) const override
+    {
+        index_type index;
+
+        if (!read(static_cast<void*>(&index), sizeof(index_type), buffer, buffer_size, buffer_offset))
+            return false;
+
+        if (index >= sizeof...(_Types))
+            return false;
+
+        auto& self = const_cast<variant&>(*this);
+
+        // the held object is reused when the type has not changed
+        if (index != index_)
+        {
+            self.value_.reset(factories[index]());
+            self.index_ = index;
+        }
+
+        return value_->deserialize(buffer, buffer_size, buffer_offset);
+    }
+
+    virtual std::unique_ptr<part_cursor> encode_parts() const override
+    {
+        return make_cursor([this](const size_t index, value_part& part)
+        {
+            if (index > 1)
+                return part_cursor::step::END;
+
+            part = index == 0 ? bytes_part(&index_, sizeof(index_type)) : value_part{ value_.get() };
+
+            return part_cursor::step::PART;
+        });
+    }
+
+    virtual std::unique_ptr<part_cursor> decode_parts() const override
+    {
+        return make_cursor([this, index = index_type(0)](const size_t position, value_part& part) mutable
+        {
+            using step = part_cursor::step;
+
+            if (position == 0)
+            {
+                part = bytes_part(&index, sizeof(index_type));
+                return step::PART;
+            }
+
+            if (position > 1)
+                return step::END;
+
+            if (index >= sizeof...(_Types))
+                return step::INVALID;
+
+            auto& self = const_cast<variant&>(*this);
+
+            if (index != index_)
+            {
+                self.value_.reset(factories[index]());
+                self.index_ = index;
+            }
+
+            part = { value_.get() };
+
+            return step::PART;
+        });
+    }
+
+private:
+    template<typename T>
+    static base* create()
+    {
+        return new T;
+    }
+
+    static constexpr std::array<base* (*)(), sizeof...(_Types)> factories = { &create<_Types>... };
+
+    index_type index_ = 0;
+    std::unique_ptr<base> value_ { factories[0]() };
+};
+
+} // namespace srlz
+
+#endif // SRLZ_VARIANT_HPP
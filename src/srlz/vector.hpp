@@ -9,6 +9,8 @@
 #define SRLZ_VECTOR_HPP
 
 #include <memory>
+#include <memory_resource>
+#include <optional>
 #include <vector>
 
 #include "member_type.h"
@@ -17,11 +19,120 @@
 namespace srlz
 {
 
-template<typename _Tp/*, typename _Alloc = std::allocator<_Tp> */>
-class vector final : public base, public std::vector<std::unique_ptr<_Tp>/*, _Alloc*/>
+/**
+ * @brief destroys and frees an element with the allocator which created it
+ */
+template<typename _Alloc>
+class allocator_delete
+{
+public:
+    using traits = std::allocator_traits<_Alloc>;
+
+    allocator_delete() = default;
+    explicit allocator_delete(const _Alloc& allocator) : allocator(allocator) {}
+
+    void operator()(typename traits::value_type* const item)
+    {
+        traits::destroy(allocator, item);
+        traits::deallocate(allocator, item, 1);
+    }
+
+private:
+    _Alloc allocator;
+};
+
+/**
+ * @brief elements of the default allocator are plain std::unique_ptr
+ */
+template<typename _Tp, typename _Alloc>
+struct element_pointer
+{
+    using type = std::unique_ptr<_Tp, allocator_delete<typename std::allocator_traits<_Alloc>::template rebind_alloc<_Tp>>>;
+};
+
+template<typename _Tp>
+struct element_pointer<_Tp, std::allocator<_Tp>>
+{
+    using type = std::unique_ptr<_Tp>;
+};
+
+/**
+ * @brief elements and the pointer array are allocated by _Alloc,
+ * a std::pmr allocator is passed on to allocator-aware elements such as pmr::string
+ */
+template<typename _Tp, typename _Alloc = std::allocator<_Tp>>
+class vector final : public base,
+    public std::vector<typename element_pointer<_Tp, _Alloc>::type,
+        typename std::allocator_traits<_Alloc>::template rebind_alloc<typename element_pointer<_Tp, _Alloc>::type>>
 {
 public:
+    using pointer_type = typename element_pointer<_Tp, _Alloc>::type;
+    using container_type = std::vector<pointer_type, typename std::allocator_traits<_Alloc>::template rebind_alloc<pointer_type>>;
+
+    static constexpr size_t min_serialized_size = sizeof(size_t);
+
     virtual ~vector() = default;
+    vector() = default;
+    explicit vector(const _Alloc& allocator) : container_type(allocator) {}
+    vector(vector&&) = default;
+    vector& operator=(vector&&) = default;
+
+    /**
+     * @brief a new element allocated by the allocator of the vector
+     */
+    pointer_type make_item() const
+    {
+        if constexpr (std::is_same_v<_Alloc, std::allocator<_Tp>>)
+            return std::make_unique<_Tp>();
+        else
+        {
+            using item_allocator = typename std::allocator_traits<_Alloc>::template rebind_alloc<_Tp>;
+            using traits = std::allocator_traits<item_allocator>;
+
+            item_allocator allocator(this->get_allocator());
+            _Tp* const item = traits::allocate(allocator, 1);
+
+            try
+            {
+                traits::construct(allocator, item);
+            }
+            catch (...)
+            {
+                traits::deallocate(allocator, item, 1);
+                throw;
+            }
+
+            return pointer_type(item, allocator_delete<item_allocator>(allocator));
+        }
+    }
+
+    /**
+     * @brief the pointer array and every element
+     */
+    virtual footprint get_footprint() const override
+    {
+        footprint result;
+
+        if (this->capacity() > 0)
+            result += { 1, this->capacity() * sizeof(pointer_type) };
+
+        for (auto& item : *((container_type*)this))
+            result += footprint{ 1, sizeof(_Tp) } + item->get_footprint();
+
+        return result;
+    }
+
+    virtual void link_entities(const serializable* const parent) const override
+    {
+        for (auto& item : *((container_type*)this))
+            item->link_entities(parent);
+    }
+
+    virtual void describe_layout(xxh64& hash) const override
+    {
+        describe(hash, layout_tag::VECTOR);
+        describe_item<_Tp>(hash);
+    }
 
     virtual bool serialize(
         char* const buffer,
@@ -31,11 +142,24 @@ public:
     {
         const size_t length = this->size();
 
-        if (!write(static_cast<const void* const>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
+        if (!write(static_cast<const void*>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
             return false;
 
-        for (auto& item : *((std::vector<std::unique_ptr<_Tp>>*)this))
-            if(!item->serialize(buffer, buffer_size, buffer_offset))
+        for (auto& item : *((container_type*)this))
+            if (!serialize_item(*item, buffer, buffer_size, buffer_offset))
+                return false;
+
+        return true;
+    }
+
+    virtual bool gather(iovec_list& list) const override
+    {
+        const size_t length = this->size();
+
+        list.copy(static_cast<const void*>(&length), sizeof(size_t));
+
+        for (auto& item : *((container_type*)this))
+            if (!item->gather(list))
                 return false;
 
         return true;
@@ -49,25 +173,122 @@ public:
     {
         size_t length;
 
-        if (!read(static_cast<void* const>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
+        if (!read(static_cast<void*>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
             return false;
 
-        ((std::vector<std::unique_ptr<_Tp>>*)this)->clear();
+        if (!check_length(length, min_item_size<_Tp>(), buffer_size, buffer_offset) || !limits_scope::allocate(length, sizeof(_Tp)))
+            return false;
+
+        ((container_type*)this)->clear();
 
         for (; length > 0; --length)
         {
-            _Tp* item = new _Tp();
+            auto item = make_item();
+            plan_item(*item);
 
-            if (!item->deserialize(buffer, buffer_size, buffer_offset))
+            if (!deserialize_item(*item, buffer, buffer_size, buffer_offset))
                 return false;
 
-            ((std::vector<std::unique_ptr<_Tp>>*)this)->push_back(std::unique_ptr<_Tp>(item));
+            ((container_type*)this)->push_back(std::move(item));
         }
 
         return true;
     }
+
+    /**
+     * @brief the length and the elements one by one
+     */
+    virtual std::unique_ptr<part_cursor> encode_parts() const override
+    {
+        return make_cursor([this, length = this->size()](const size_t index, value_part& part)
+        {
+            if (index > length)
+                return part_cursor::step::END;
+
+            part = index == 0 ? bytes_part(&length, sizeof(size_t)) : value_part{ (*this)[index - 1].get() };
+
+            return part_cursor::step::PART;
+        });
+    }
+
+    /**
+     * @brief an element is appended once it has been read
+     */
+    virtual std::unique_ptr<part_cursor> decode_parts() const override
+    {
+        return make_cursor([this, length = size_t(0), item = std::optional<pointer_type>()](const size_t index, value_part& part) mutable
+        {
+            using step = part_cursor::step;
+
+            auto& self = *((container_type*)this);
+
+            if (index == 0)
+            {
+                part = bytes_part(&length, sizeof(size_t));
+                return step::PART;
+            }
+
+            if (index == 1)
+            {
+                if (!limits_scope::allocate(length, sizeof(_Tp)))
+                    return step::INVALID;
+
+                self.clear();
+            }
+            else
+                self.push_back(std::move(*item));
+
+            if (index > length)
+                return step::END;
+
+            // the deleter of an allocator-aware element cannot be assigned, so the element is emplaced
+            item.emplace(make_item());
+            plan_item(**item);
+            part = { item->get() };
+
+            return step::PART;
+        });
+    }
+
+private:
+    /**
+     * @brief an element of a final type is called directly, so static_serializable elements are inlined
+     */
+    static bool serialize_item(
+        const _Tp& item,
+        char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        )
+    {
+        if constexpr (std::is_final_v<_Tp>)
+            return item._Tp::serialize(buffer, buffer_size, buffer_offset);
+        else
+            return item.serialize(buffer, buffer_size, buffer_offset);
+    }
+
+    static bool deserialize_item(
+        const _Tp& item,
+        const char* const buffer,
+        const size_t buffer_size,
+        size_t& buffer_offset
+        )
+    {
+        if constexpr (std::is_final_v<_Tp>)
+            return item._Tp::deserialize(buffer, buffer_size, buffer_offset);
+        else
+            return item.deserialize(buffer, buffer_size, buffer_offset);
+    }
 };
 
+namespace pmr
+{
+
+template<typename _Tp>
+using vector = srlz::vector<_Tp, std::pmr::polymorphic_allocator<_Tp>>;
+
+} // namespace pmr
+
 } // namespace srlz
 
 #endif // SRLZ_VECTOR_HPP
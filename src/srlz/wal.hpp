@@ -0,0 +1,295 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_WAL_HPP
+#define SRLZ_WAL_HPP
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "base.hpp"
+#include "framed.hpp"
+#include "xxhash.hpp"
+
+namespace srlz
+{
+
+/**
+ * @brief frame of a record in the log: the length of the payload and its checksum seeded with the length,
+ * so a zeroed or torn tail never passes as a record
+ */
+struct wal_frame
+{
+    uint32_t length;
+    uint32_t checksum;
+
+    static uint32_t checksum_of(const char* const payload, const uint32_t length) noexcept
+    {
+        return uint32_t(xxh64::hash(payload, length, length));
+    }
+};
+
+/**
+ * @brief reads the records of a log in place from a read-only mapping, stops at the end or at the first broken frame,
+ * the mapping lives as long as the reader
+ */
+class wal_reader final
+{
+public:
+    using record_view = srlz::record_view;
+
+    explicit wal_reader(const char* const path)
+    {
+        const int fd = ::open(path, O_RDONLY);
+
+        if (fd < 0)
+            return;
+
+        struct stat status;
+
+        if (fstat(fd, &status) != 0)
+        {
+            close(fd);
+
+            return;
+        }
+
+        if (status.st_size > 0)
+        {
+            void* const memory = mmap(nullptr, size_t(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (memory != MAP_FAILED)
+            {
+                data = static_cast<const char*>(memory);
+                size = size_t(status.st_size);
+            }
+        }
+
+        opened = status.st_size == 0 || data;
+        close(fd);
+    }
+
+    ~wal_reader()
+    {
+        if (data)
+            munmap(const_cast<char*>(data), size);
+    }
+
+    wal_reader(const wal_reader&) = delete;
+    wal_reader& operator=(const wal_reader&) = delete;
+
+    bool is_open() const noexcept
+    {
+        return opened;
+    }
+
+    /**
+     * @brief the next record, false at the end of the log or at a torn tail
+     */
+    bool next(record_view& view) noexcept
+    {
+        wal_frame frame;
+
+        if (size - offset < sizeof(wal_frame))
+            return false;
+
+        std::memcpy(&frame, data + offset, sizeof(wal_frame));
+
+        const char* const payload = data + offset + sizeof(wal_frame);
+
+        if (frame.length > size - offset - sizeof(wal_frame) || frame.checksum != wal_frame::checksum_of(payload, frame.length))
+            return false;
+
+        view = { payload, frame.length };
+        offset += sizeof(wal_frame) + frame.length;
+
+        return true;
+    }
+
+    /**
+     * @brief the end of the last record read, where a torn tail begins
+     */
+    size_t get_offset() const noexcept
+    {
+        return offset;
+    }
+
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+    size_t offset = 0;
+    bool opened = false;
+};
+
+/**
+ * @brief append-only log of framed records, appenders that arrive while a batch is written
+ * form the next batch, which the first of them writes and syncs with a single fdatasync for all,
+ * append returns once its record is durable, a torn tail left by a crash is cut off on opening
+ */
+class wal final
+{
+public:
+    explicit wal(const char* const path)
+    {
+        size_t valid_size;
+
+        {
+            wal_reader reader(path);
+
+            if (!reader.is_open() && access(path, F_OK) == 0)
+                return;
+
+            wal_reader::record_view view;
+
+            while (reader.next(view)) {}
+
+            valid_size = reader.get_offset();
+        }
+
+        fd = ::open(path, O_CREAT | O_WRONLY, S_IRUSR | S_IWUSR);
+
+        if (fd < 0)
+            return;
+
+        if (ftruncate(fd, off_t(valid_size)) != 0 || lseek(fd, off_t(valid_size), SEEK_SET) < 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    ~wal()
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+
+    wal(const wal&) = delete;
+    wal& operator=(const wal&) = delete;
+
+    bool is_open() const noexcept
+    {
+        return fd >= 0;
+    }
+
+    /**
+     * @brief false if the log is closed, a write failed or the record does not fit a frame
+     */
+    bool append(const base& record)
+    {
+        static thread_local std::vector<char> scratch(256);
+        const size_t checkpoint = dictionary_scope::checkpoint();
+        size_t offset;
+
+        while (!record.serialize(scratch.data(), scratch.size(), offset = sizeof(wal_frame)))
+        {
+            dictionary_scope::rollback(checkpoint);
+
+            if (scratch.size() > UINT32_MAX)
+                return false;
+
+            scratch.resize(scratch.size() * 2);
+        }
+
+        const uint32_t length = uint32_t(offset - sizeof(wal_frame));
+        const wal_frame frame { length, wal_frame::checksum_of(scratch.data() + sizeof(wal_frame), length) };
+        std::memcpy(scratch.data(), &frame, sizeof(wal_frame));
+
+        std::unique_lock lock(mutex);
+
+        if (fd < 0 || failed)
+            return false;
+
+        pending.insert(pending.end(), scratch.data(), scratch.data() + offset);
+
+        const uint64_t ticket = ++appended;
+
+        while (durable < ticket && !failed)
+        {
+            if (writing)
+            {
+                condition.wait(lock);
+
+                continue;
+            }
+
+            writing = true;
+            batch.swap(pending);
+
+            const uint64_t batch_end = appended;
+            lock.unlock();
+
+            const bool success = write_all(batch.data(), batch.size()) && fdatasync(fd) == 0;
+
+            lock.lock();
+            batch.clear();
+            writing = false;
+            failed = failed || !success;
+
+            if (success)
+                durable = batch_end;
+
+            condition.notify_all();
+        }
+
+        return durable >= ticket;
+    }
+
+    /**
+     * @brief records which have been appended and synced
+     */
+    uint64_t get_durable_count() const
+    {
+        std::lock_guard lock(mutex);
+
+        return durable;
+    }
+
+private:
+    bool write_all(const char* data, size_t length) noexcept
+    {
+        while (length > 0)
+        {
+            const ssize_t written = ::write(fd, data, length);
+
+            if (written < 0 && errno == EINTR)
+                continue;
+
+            if (written < 0)
+                return false;
+
+            data += written;
+            length -= size_t(written);
+        }
+
+        return true;
+    }
+
+    int fd = -1;
+    std::vector<char> pending;
+    std::vector<char> batch;
+    uint64_t appended = 0;
+    uint64_t durable = 0;
+    bool writing = false;
+    bool failed = false;
+    mutable std::mutex mutex;
+    std::condition_variable condition;
+};
+
+} // namespace srlz
+
+#endif // SRLZ_WAL_HPP
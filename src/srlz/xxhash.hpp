@@ -0,0 +1,186 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#ifndef SRLZ_XXHASH_HPP
+#define SRLZ_XXHASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace srlz
+{
+
+/**
+ * @brief streaming XXH64, the digest equals the one shot hash of all updates concatenated
+ */
+class xxh64 final
+{
+public:
+    explicit xxh64(const uint64_t seed = 0) noexcept
+    {
+        reset(seed);
+    }
+
+    void reset(const uint64_t seed = 0) noexcept
+    {
+        this->seed = seed;
+        accumulators[0] = seed + prime_1 + prime_2;
+        accumulators[1] = seed + prime_2;
+        accumulators[2] = seed;
+        accumulators[3] = seed - prime_1;
+        total_length = 0;
+        buffered = 0;
+    }
+
+    void update(const void* const data, size_t length) noexcept
+    {
+        const unsigned char* input = static_cast<const unsigned char*>(data);
+        total_length += length;
+
+        if (buffered + length < stripe_size)
+        {
+            if (length > 0)
+                std::memcpy(buffer + buffered, input, length);
+
+            buffered += length;
+
+            return;
+        }
+
+        if (buffered > 0)
+        {
+            const size_t fill = stripe_size - buffered;
+            std::memcpy(buffer + buffered, input, fill);
+            consume(buffer);
+            input += fill;
+            length -= fill;
+            buffered = 0;
+        }
+
+        for (; length >= stripe_size; input += stripe_size, length -= stripe_size)
+            consume(input);
+
+        if (length > 0)
+            std::memcpy(buffer, input, length);
+
+        buffered = length;
+    }
+
+    uint64_t digest() const noexcept
+    {
+        uint64_t hash;
+
+        if (total_length >= stripe_size)
+        {
+            hash = rotate(accumulators[0], 1) + rotate(accumulators[1], 7)
+                + rotate(accumulators[2], 12) + rotate(accumulators[3], 18);
+
+            for (auto accumulator : accumulators)
+            {
+                hash ^= round(0, accumulator);
+                hash = hash * prime_1 + prime_4;
+            }
+        }
+        else
+            hash = seed + prime_5;
+
+        hash += total_length;
+
+        const unsigned char* input = buffer;
+        size_t length = buffered;
+
+        for (; length >= 8; input += 8, length -= 8)
+        {
+            hash ^= round(0, read64(input));
+            hash = rotate(hash, 27) * prime_1 + prime_4;
+        }
+
+        if (length >= 4)
+        {
+            hash ^= uint64_t(read32(input)) * prime_1;
+            hash = rotate(hash, 23) * prime_2 + prime_3;
+            input += 4;
+            length -= 4;
+        }
+
+        for (; length > 0; ++input, --length)
+        {
+            hash ^= *input * prime_5;
+            hash = rotate(hash, 11) * prime_1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= prime_2;
+        hash ^= hash >> 29;
+        hash *= prime_3;
+        hash ^= hash >> 32;
+
+        return hash;
+    }
+
+    static uint64_t hash(const void* const data, const size_t length, const uint64_t seed = 0) noexcept
+    {
+        xxh64 state(seed);
+        state.update(data, length);
+
+        return state.digest();
+    }
+
+private:
+    static constexpr uint64_t prime_1 = 0x9E3779B185EBCA87ULL;
+    static constexpr uint64_t prime_2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr uint64_t prime_3 = 0x165667B19E3779F9ULL;
+    static constexpr uint64_t prime_4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr uint64_t prime_5 = 0x27D4EB2F165667C5ULL;
+    static constexpr size_t stripe_size = 32;
+
+    static uint64_t rotate(const uint64_t value, const int bits) noexcept
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    static uint64_t round(uint64_t accumulator, const uint64_t input) noexcept
+    {
+        accumulator += input * prime_2;
+
+        return rotate(accumulator, 31) * prime_1;
+    }
+
+    // the format is little endian, as is the rest of the wire format
+    static uint64_t read64(const unsigned char* const input) noexcept
+    {
+        uint64_t value;
+        std::memcpy(&value, input, sizeof(value));
+
+        return value;
+    }
+
+    static uint32_t read32(const unsigned char* const input) noexcept
+    {
+        uint32_t value;
+        std::memcpy(&value, input, sizeof(value));
+
+        return value;
+    }
+
+    void consume(const unsigned char* const stripe) noexcept
+    {
+        for (size_t i = 0; i < 4; ++i)
+            accumulators[i] = round(accumulators[i], read64(stripe + i * 8));
+    }
+
+    uint64_t seed;
+    uint64_t accumulators[4];
+    uint64_t total_length;
+    unsigned char buffer[stripe_size];
+    size_t buffered;
+};
+
+} // namespace srlz
+
+#endif // SRLZ_XXHASH_HPP
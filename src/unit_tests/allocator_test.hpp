@@ -0,0 +1,130 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <memory_resource>
+#include <unordered_set>
+
+#include "srlz/serializable.hpp"
+#include "srlz/string.hpp"
+#include "srlz/vector.hpp"
+
+namespace allocator_test_entities
+{
+
+/**
+ * @brief counts the bytes taken from the upstream resource
+ */
+class counting_resource final : public std::pmr::memory_resource
+{
+public:
+    size_t allocated = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        allocated += bytes;
+
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        allocated -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+} // namespace allocator_test_entities
+
+void allocator_test()
+{
+    using namespace std::string_literals;
+
+    using namespace srlz;
+    using namespace allocator_test_entities;
+
+    class entity final : public serializable
+    {
+    public:
+        virtual ~entity() = default;
+        entity() : serializable(member_vector) {}
+
+        member<vector<string>, member_type::SRLZ> names;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&names)
+        };
+    };
+
+    const std::string long_name{"a name long enough to be allocated outside of the string object"s};
+
+    entity first;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        first.names.get_unsafe().push_back(first.names.get().make_item());
+        first.names.get().back()->set(long_name + std::to_string(i));
+    }
+
+    char buffer[2048];
+    size_t offset;
+
+    assert(first.serialize(buffer, sizeof(buffer), offset = 0));
+    const size_t size = offset;
+
+    // the vector of an entity member is read into a pmr vector through the same wire format
+    {
+        counting_resource resource;
+        pmr::vector<pmr::string> names(&resource);
+
+        assert(names.deserialize(buffer + sizeof(bool), size - sizeof(bool), offset = 0));
+        assert(size - sizeof(bool) == offset);
+        assert(10 == names.size());
+
+        for (int i = 0; i < 10; ++i)
+        {
+            assert(long_name + std::to_string(i) == std::string_view(*names[i]));
+            assert(&resource == names[i]->get_allocator().resource());
+        }
+
+        const size_t expected = 10 * sizeof(pmr::string) + 10 * (long_name.size() + 2);
+        assert(resource.allocated >= expected);
+
+        std::unordered_set<pmr::string> unique;
+        unique.insert(*names[0]);
+        assert(unique.count(*names[0]) == 1);
+
+        names.clear();
+        assert(resource.allocated < 10 * sizeof(pmr::string));
+    }
+
+    {
+        char arena[8192];
+        std::pmr::monotonic_buffer_resource resource(arena, sizeof(arena), std::pmr::null_memory_resource());
+        pmr::vector<pmr::string> names(&resource);
+
+        assert(names.deserialize(buffer + sizeof(bool), size - sizeof(bool), offset = 0));
+
+        for (auto& name : names)
+        {
+            assert(name->data() >= arena && name->data() < arena + sizeof(arena));
+            assert(reinterpret_cast<char*>(name.get()) >= arena);
+        }
+
+        pmr::vector<pmr::string> moved(std::move(names));
+        assert(10 == moved.size());
+        assert(moved.serialize(buffer, sizeof(buffer), offset = 0));
+        assert(size - sizeof(bool) == offset);
+    }
+}
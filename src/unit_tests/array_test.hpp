@@ -0,0 +1,67 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+
+#include "debug_helper.hpp"
+#include "srlz/array.hpp"
+#include "srlz/serializable.hpp"
+
+void array_test()
+{
+    using namespace srlz;
+
+    class entity final : public serializable
+    {
+    public:
+        virtual ~entity() = default;
+        entity() : serializable(member_vector) {}
+
+        member<array<float, 16>, member_type::SRLZ> matrix;
+        member<array<uint8_t, 16>, member_type::SRLZ> address;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&matrix),
+            static_cast<void*>(&address)
+        };
+    };
+
+    static_assert(array<float, 16>::max_serialized_size == sizeof(float) * 16);
+    static_assert(array<uint8_t, 16>::max_serialized_size == 16);
+
+    entity first;
+    entity second;
+
+    for (size_t i = 0; i < 16; ++i)
+    {
+        first.matrix.get_unsafe()[i] = i * 0.5F;
+        first.address.get_unsafe()[i] = uint8_t(i + 1);
+    }
+
+    constexpr size_t expected_size =
+        sizeof(bool) + sizeof(float) * 16 +
+        sizeof(bool) + sizeof(uint8_t) * 16;
+
+    char buffer[expected_size];
+    size_t offset;
+
+    assert(first.serialize(buffer, expected_size, offset = 0));
+    assert(expected_size == offset);
+    assert(second.deserialize(buffer, expected_size, offset = 0));
+    assert(expected_size == offset);
+
+    for (size_t i = 0; i < 16; ++i)
+    {
+        assert(first.matrix.get()[i] == second.matrix.get()[i]);
+        assert(first.address.get()[i] == second.address.get()[i]);
+    }
+
+    assert(!second.deserialize(buffer, expected_size - 1, offset = 0));
+
+    //debug_helper(buffer, serialize_offset);
+}
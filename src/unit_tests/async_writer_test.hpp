@@ -0,0 +1,80 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "srlz/async_writer.hpp"
+#include "srlz/serializable.hpp"
+#include "srlz/string.hpp"
+
+void async_writer_test()
+{
+    using namespace srlz;
+
+    class entity final : public serializable
+    {
+    public:
+        virtual ~entity() = default;
+        entity() : serializable(member_vector) {}
+
+        member<int32_t, member_type::INT_32> i;
+        member<string, member_type::SRLZ> str;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&i),
+            static_cast<void*>(&str)
+        };
+    };
+
+    const auto path = std::filesystem::temp_directory_path() / "srlz_async_writer_test.bin";
+    constexpr int32_t count = 1000;
+
+    {
+        async_writer writer(path.string().c_str(), 256, 3, 200);
+        assert(writer.is_open());
+
+        entity first;
+
+        for (int32_t i = 0; i < count; ++i)
+        {
+            first.i.set(i);
+            first.str.get_unsafe().set(std::string(size_t(i % 32), 'a'));
+            assert(writer.write(first));
+
+            if (i == count / 2)
+                assert(writer.flush());
+        }
+
+        first.str.get_unsafe().set(std::string(256, 'a'));
+        assert(!writer.write(first));
+
+        assert(writer.close());
+        assert(!writer.write(first));
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    const std::vector<char> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::filesystem::remove(path);
+
+    entity second;
+    size_t offset = 0;
+
+    for (int32_t i = 0; i < count; ++i)
+    {
+        assert(second.deserialize(buffer.data(), buffer.size(), offset));
+        assert(i == second.i.get());
+        assert(size_t(i % 32) == second.str.get().length());
+    }
+
+    assert(buffer.size() == offset);
+}
@@ -0,0 +1,166 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory_resource>
+#include <stdexcept>
+
+#include "srlz/blob.hpp"
+#include "srlz/chunked.hpp"
+#include "srlz/serializable.hpp"
+
+void blob_test()
+{
+    using namespace srlz;
+
+    using aligned_blob = blob<64>;
+
+    class entity final : public serializable
+    {
+    public:
+        virtual ~entity() = default;
+        entity() : serializable(member_vector) {}
+
+        member<int32_t, member_type::INT_32> id;
+        member<aligned_blob, member_type::SRLZ> image;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&id),
+            static_cast<void*>(&image)
+        };
+    };
+
+    constexpr size_t size = 1000;
+    unsigned char pixels[size];
+
+    for (size_t i = 0; i < size; ++i)
+        pixels[i] = static_cast<unsigned char>(i * 3);
+
+    {
+        entity first;
+        entity second;
+        first.id.set(7);
+        first.image.get_unsafe().assign(pixels, size);
+
+        assert(0 == reinterpret_cast<uintptr_t>(first.image.get().data()) % 64);
+        assert(size == first.image.get().size());
+        assert(first.image.get().capacity() >= size);
+
+        constexpr size_t expected_size =
+            sizeof(bool) + sizeof(int32_t) +
+            sizeof(bool) + sizeof(size_t) + size;
+
+        char buffer[expected_size];
+        size_t offset;
+
+        assert(first.serialize(buffer, expected_size, offset = 0));
+        assert(expected_size == offset);
+        assert(second.deserialize(buffer, expected_size, offset = 0));
+        assert(expected_size == offset);
+        assert(7 == second.id.get());
+        assert(size == second.image.get().size());
+        assert(0 == std::memcmp(pixels, second.image.get().data(), size));
+        assert(0 == reinterpret_cast<uintptr_t>(second.image.get().data()) % 64);
+
+        // a smaller value reuses the buffer
+        const unsigned char* const data = second.image.get().data();
+        const size_t capacity = second.image.get().capacity();
+        first.image.get_unsafe().resize(10);
+
+        assert(first.serialize(buffer, expected_size, offset = 0));
+        const size_t small_size = offset;
+        assert(second.deserialize(buffer, expected_size, offset = 0));
+        assert(10 == second.image.get().size());
+        assert(data == second.image.get().data());
+        assert(capacity == second.image.get().capacity());
+        assert(0 == std::memcmp(pixels, second.image.get().data(), 10));
+
+        // a truncated buffer fails without growing
+        assert(!second.deserialize(buffer, small_size - 1, offset = 0));
+        assert(data == second.image.get().data());
+    }
+
+    {
+        aligned_blob first;
+        first.assign(pixels, size);
+        aligned_blob second(first);
+
+        assert(size == second.size());
+        assert(first.data() != second.data());
+
+        const unsigned char* const data = first.data();
+        aligned_blob third(std::move(first));
+
+        assert(data == third.data());
+        assert(first.empty() && first.capacity() == 0);
+
+        third.resize(2 * size);
+
+        assert(0 == std::memcmp(pixels, third.data(), size));
+    }
+
+    {
+        char arena[4096];
+        std::pmr::monotonic_buffer_resource resource(arena, sizeof(arena), std::pmr::null_memory_resource());
+        using pmr_blob = blob<32, std::pmr::polymorphic_allocator<unsigned char>>;
+
+        pmr_blob source(&resource);
+        source.assign(pixels, size);
+
+        assert(source.data() >= reinterpret_cast<unsigned char*>(arena));
+        assert(source.data() < reinterpret_cast<unsigned char*>(arena) + sizeof(arena));
+        assert(0 == reinterpret_cast<uintptr_t>(source.data()) % 32);
+        assert(&resource == source.get_allocator().resource());
+
+        char buffer[sizeof(size_t) + size];
+        size_t offset;
+        pmr_blob target(&resource);
+
+        assert(source.serialize(buffer, sizeof(buffer), offset = 0));
+        assert(target.deserialize(buffer, sizeof(buffer), offset = 0));
+        assert(0 == std::memcmp(pixels, target.data(), size));
+        assert(target.data() >= reinterpret_cast<unsigned char*>(arena));
+    }
+
+    // a length whose blocks overflow is rejected before anything is allocated
+    {
+        char buffer[sizeof(size_t) + 64] = {};
+        const size_t length = std::numeric_limits<size_t>::max() - 2;
+        std::memcpy(buffer, &length, sizeof(size_t));
+        size_t offset;
+
+        blob<16> target;
+        assert(!target.deserialize(buffer, sizeof(buffer), offset = 0));
+        assert(0 == target.capacity());
+
+        bool thrown = false;
+
+        try
+        {
+            target.reserve(length);
+        }
+        catch (const std::length_error&)
+        {
+            thrown = true;
+        }
+
+        assert(thrown && 0 == target.capacity());
+
+#ifdef SRLZ_COROUTINES
+        // the length is rejected as soon as it has been read
+        decoder decoding(target);
+        assert(decoding.feed(buffer, sizeof(buffer)));
+        assert(!decoding.success());
+        assert(!decoding.finish());
+        assert(0 == target.capacity());
+#endif // SRLZ_COROUTINES
+    }
+}
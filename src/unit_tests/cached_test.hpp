@@ -0,0 +1,282 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#include "srlz/canonical.hpp"
+#include "srlz/iovec_list.hpp"
+#include "srlz/map.hpp"
+#include "srlz/serializable.hpp"
+#include "srlz/string.hpp"
+#include "srlz/vector.hpp"
+
+void cached_test()
+{
+    using namespace srlz;
+
+    class nested_entity final : public serializable
+    {
+    public:
+        virtual ~nested_entity() = default;
+        nested_entity() : serializable(member_vector) {}
+
+        member<int32_t, member_type::INT_32> i;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&i)
+        };
+    };
+
+    class entity final : public serializable
+    {
+    public:
+        virtual ~entity() = default;
+        entity() : serializable(member_vector) {}
+
+        member<double, member_type::DOUBLE> d;
+        member<string, member_type::SRLZ> str;
+        member<nested_entity, member_type::SRLZ> nested;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&d),
+            static_cast<void*>(&str),
+            static_cast<void*>(&nested)
+        };
+    };
+
+    const auto serialized = [](const serializable& value, char (&buffer)[256])
+    {
+        size_t offset = 0;
+        const bool success = value.serialize(buffer, sizeof(buffer), offset);
+        assert(success);
+
+        return offset;
+    };
+
+    entity first;
+    first.d.set(1.5);
+    first.str.get_unsafe().set("reference data");
+    first.nested.get_unsafe().i.set(7);
+
+    char expected[256];
+    const size_t expected_size = serialized(first, expected);
+
+    first.enable_cache();
+    assert(!first.is_cached());
+
+    char buffer[256];
+    assert(expected_size == serialized(first, buffer));
+    assert(0 == std::memcmp(expected, buffer, expected_size));
+    assert(first.is_cached());
+
+    // a nested entity only invalidates its parent
+    assert(!first.nested.get().is_cache_enabled() && !first.nested.get().is_cached());
+
+    // the cached bytes are written as they are
+    const auto cached = first.get_cached();
+    assert(cached && cached->size() == expected_size);
+    const_cast<char&>(cached->front()) = 0;
+    assert(expected_size == serialized(first, buffer));
+    assert(0 == buffer[0]);
+    const_cast<char&>(cached->front()) = expected[0];
+
+    // a too small buffer fails without touching the cache
+    {
+        size_t offset = 0;
+        assert(!first.serialize(buffer, expected_size - 1, offset));
+        assert(first.is_cached());
+    }
+
+    {
+        iovec_list list(1);
+        assert(first.gather(list));
+        assert(1 == list.get_segments().size());
+        assert(cached->data() == list.get_segments().front().base);
+    }
+
+    // a change of a member
+    first.d.set(2.5);
+    assert(!first.is_cached());
+    serialized(first, buffer);
+    assert(first.is_cached());
+
+    // the holder keeps the old bytes
+    assert(0 == std::memcmp(expected, cached->data(), expected_size));
+
+    entity second;
+    second.d.set(2.5);
+    second.str.get_unsafe().set("reference data");
+    second.nested.get_unsafe().i.set(7);
+    serialized(second, expected);
+    assert(0 == std::memcmp(expected, buffer, expected_size));
+
+    // a change of a nested entity through a kept reference
+    nested_entity& nested = first.nested.get_unsafe();
+    serialized(first, buffer);
+    assert(first.is_cached());
+    nested.i.set(8);
+    assert(!first.is_cached() && !nested.is_cached());
+    second.nested.get_unsafe().i.set(8);
+    serialized(second, expected);
+    serialized(first, buffer);
+    assert(0 == std::memcmp(expected, buffer, expected_size));
+
+    // a container member changed through get_unsafe
+    first.str.get_unsafe().set("reference date");
+    second.str.get_unsafe().set("reference date");
+    serialized(second, expected);
+    serialized(first, buffer);
+    assert(0 == std::memcmp(expected, buffer, expected_size));
+
+    // deserialization and assignment
+    {
+        second.d.set(3.5);
+        serialized(second, expected);
+
+        size_t offset = 0;
+        assert(first.deserialize(expected, expected_size, offset));
+        assert(!first.is_cached());
+        serialized(first, buffer);
+        assert(0 == std::memcmp(expected, buffer, expected_size));
+
+        second.d.set(4.5);
+        serialized(second, expected);
+        static_cast<serializable&>(first) = std::move(second);
+        assert(!first.is_cached());
+        serialized(first, buffer);
+        assert(0 == std::memcmp(expected, buffer, expected_size));
+
+        // the nested entity taken from second is tracked
+        nested_entity& moved = first.nested.get_unsafe();
+        serialized(first, buffer);
+        moved.i.set(9);
+        assert(!first.is_cached());
+    }
+
+    // elements of containers, inserted before or after the cache was enabled
+    {
+        class holder final : public serializable
+        {
+        public:
+            virtual ~holder() = default;
+            holder() : serializable(member_vector) {}
+
+            member<vector<nested_entity>, member_type::SRLZ> items;
+            member<map<int32_t, nested_entity>, member_type::SRLZ> keyed;
+
+            serializable::member_vector_type member_vector =
+            {
+                static_cast<void*>(&items),
+                static_cast<void*>(&keyed)
+            };
+        };
+
+        holder cached;
+        holder plain;
+        cached.items.get_unsafe().push_back(cached.items.get().make_item());
+        cached.items.get().back()->i.set(0);
+        cached.enable_cache();
+        cached.items.get_unsafe().push_back(cached.items.get().make_item());
+        cached.items.get().back()->i.set(0);
+        cached.keyed.get_unsafe()[1].i.set(1);
+
+        for (int n = 0; n < 2; ++n)
+        {
+            plain.items.get_unsafe().push_back(plain.items.get().make_item());
+            plain.items.get().back()->i.set(0);
+        }
+
+        plain.keyed.get_unsafe()[1].i.set(1);
+
+        const auto same = [&]()
+        {
+            char cached_buffer[256];
+            char plain_buffer[256];
+            const size_t size = serialized(cached, cached_buffer);
+
+            return size == serialized(plain, plain_buffer) && 0 == std::memcmp(cached_buffer, plain_buffer, size);
+        };
+
+        assert(same() && cached.is_cached());
+
+        nested_entity& kept = *cached.items.get().front();
+        kept.i.set(2);
+        plain.items.get().front()->i.set(2);
+        assert(!cached.is_cached());
+        assert(same());
+
+        cached.items.get().back()->i.set(3);
+        plain.items.get().back()->i.set(3);
+        assert(!cached.is_cached());
+        assert(same());
+
+        nested_entity& value = cached.keyed.get_unsafe()[1];
+        assert(same() && cached.is_cached());
+        value.i.set(4);
+        plain.keyed.get_unsafe()[1].i.set(4);
+        assert(!cached.is_cached());
+        assert(same());
+
+        // elements created by deserialization are linked as well
+        char buffer[256];
+        const size_t size = serialized(plain, buffer);
+        size_t offset = 0;
+        assert(cached.deserialize(buffer, size, offset));
+        assert(same());
+        cached.items.get().back()->i.set(5);
+        plain.items.get().back()->i.set(5);
+        assert(same());
+
+        cached.disable_cache();
+        cached.items.get().front()->i.set(6);
+        assert(!cached.is_cached() && !cached.items.get().front()->is_cache_enabled());
+    }
+
+    // a nested entity whose cache is enabled keeps it when its parent enables and disables its own
+    {
+        entity parent;
+        parent.d.set(1.0);
+        parent.str.get_unsafe().set("text");
+        parent.nested.get_unsafe().i.set(1);
+
+        const nested_entity& nested = parent.nested.get();
+        const_cast<nested_entity&>(nested).enable_cache();
+        parent.enable_cache();
+        assert(nested.is_cache_enabled());
+
+        serialized(parent, buffer);
+        assert(parent.is_cached() && nested.is_cached());
+
+        parent.nested.get_unsafe().i.set(2);
+        assert(!parent.is_cached() && !nested.is_cached());
+
+        parent.disable_cache();
+        assert(nested.is_cache_enabled());
+        serialized(parent, buffer);
+        assert(nested.is_cached());
+    }
+
+    // canonical serialization does not use the cache
+    {
+        first.d.set(-0.0);
+        serialized(first, buffer);
+        assert(first.is_cached());
+
+        canonical_scope scope(false);
+        serialized(first, buffer);
+
+        double d;
+        std::memcpy(&d, buffer + sizeof(bool), sizeof(double));
+        assert(0.0 == d && !std::signbit(d));
+        assert(!first.get_cached());
+    }
+}
@@ -0,0 +1,253 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "srlz/array.hpp"
+#include "srlz/canonical.hpp"
+#include "srlz/columnar.hpp"
+#include "srlz/iovec_list.hpp"
+#include "srlz/map.hpp"
+#include "srlz/serializable.hpp"
+#include "srlz/unordered_map.hpp"
+#include "srlz/variant.hpp"
+#include "srlz/xxhash.hpp"
+
+void canonical_test()
+{
+    using namespace srlz;
+
+    {
+        unsigned char data[100];
+
+        for (size_t i = 0; i < sizeof(data); ++i)
+            data[i] = static_cast<unsigned char>(i);
+
+        assert(0xEF46DB3751D8E999ULL == xxh64::hash("", 0));
+        assert(0x44BC2CF5AD770999ULL == xxh64::hash("abc", 3));
+        assert(0x6AC1E58032166597ULL == xxh64::hash(data, sizeof(data)));
+        assert(0x80653E7E9B887CDDULL == xxh64::hash(data, sizeof(data), 7));
+
+        xxh64 streaming;
+
+        for (size_t offset = 0, step = 1; offset < sizeof(data); offset += step, step += 3)
+            streaming.update(data + offset, std::min(step, sizeof(data) - offset));
+
+        assert(0x6AC1E58032166597ULL == streaming.digest());
+    }
+
+    class entity final : public serializable
+    {
+    public:
+        virtual ~entity() = default;
+        entity() : serializable(member_vector) {}
+
+        member<long double, member_type::LONG_DOUBLE> precise;
+        member<double, member_type::DOUBLE> zero;
+        member<float, member_type::FLOAT> missing;
+        member<unordered_map<int32_t, int32_t>, member_type::SRLZ> counters;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&precise),
+            static_cast<void*>(&zero),
+            static_cast<void*>(&missing),
+            static_cast<void*>(&counters)
+        };
+    };
+
+    entity first;
+    entity second;
+
+    // equal values with different bytes
+    std::memset(static_cast<void*>(&first.precise.get_unsafe()), 0x00, sizeof(long double));
+    std::memset(static_cast<void*>(&second.precise.get_unsafe()), 0xAA, sizeof(long double));
+    first.precise.get_unsafe() = 1.5L;
+    second.precise.get_unsafe() = 1.5L;
+    first.zero.set(0.0);
+    second.zero.set(-0.0);
+    first.missing.set(std::numeric_limits<float>::quiet_NaN());
+    second.missing.set(-std::numeric_limits<float>::quiet_NaN());
+
+    second.counters.get_unsafe().reserve(1000);
+
+    for (int32_t i = 0; i < 100; ++i)
+    {
+        first.counters.get_unsafe()[i] = i * 2;
+        second.counters.get_unsafe()[99 - i] = (99 - i) * 2;
+    }
+
+    char first_buffer[4096];
+    char second_buffer[4096];
+    size_t first_size;
+    size_t second_size;
+    uint64_t first_digest;
+    uint64_t second_digest;
+
+    {
+        canonical_scope scope;
+        assert(scope.serialize(first, first_buffer, sizeof(first_buffer), first_size = 0));
+        first_digest = scope.digest();
+    }
+
+    {
+        canonical_scope scope;
+        assert(scope.serialize(second, second_buffer, sizeof(second_buffer), second_size = 0));
+        second_digest = scope.digest();
+    }
+
+    assert(first_size == second_size);
+    assert(0 == std::memcmp(first_buffer, second_buffer, first_size));
+    assert(first_digest == second_digest);
+    assert(xxh64::hash(first_buffer, first_size) == first_digest);
+
+    // the canonical bytes are an ordinary encoding
+    entity third;
+    size_t offset;
+
+    assert(third.deserialize(first_buffer, first_size, offset = 0));
+    assert(first_size == offset);
+    assert(1.5L == third.precise.get());
+    assert(!std::signbit(third.zero.get()));
+    assert(std::isnan(third.missing.get()));
+    assert(first.counters.get() == third.counters.get());
+
+    {
+        canonical_scope scope(true, 42);
+        assert(scope.serialize(third, second_buffer, sizeof(second_buffer), second_size = 0));
+        assert(xxh64::hash(second_buffer, second_size, 42) == scope.digest());
+    }
+
+    assert(0 == std::memcmp(first_buffer, second_buffer, first_size));
+
+    // floating values inside arrays, map keys and values and variants are normalized as well
+    class nested final : public serializable
+    {
+    public:
+        virtual ~nested() = default;
+        nested() : serializable(member_vector) {}
+
+        member<array<float, 2>, member_type::SRLZ> samples;
+        member<map<double, double>, member_type::SRLZ> curve;
+        member<unordered_map<int32_t, float>, member_type::SRLZ> weights;
+        member<variant<array<double, 1>, array<float, 1>>, member_type::SRLZ> choice;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&samples),
+            static_cast<void*>(&curve),
+            static_cast<void*>(&weights),
+            static_cast<void*>(&choice)
+        };
+    };
+
+    {
+        nested values[2];
+
+        for (int i = 0; i < 2; ++i)
+        {
+            const double zero = i ? -0.0 : 0.0;
+            const float nan = i ? -std::numeric_limits<float>::quiet_NaN() : std::numeric_limits<float>::quiet_NaN();
+
+            values[i].samples.get_unsafe()[0] = float(zero);
+            values[i].samples.get_unsafe()[1] = nan;
+            values[i].curve.get_unsafe()[zero] = zero;
+            values[i].weights.get_unsafe()[1] = nan;
+            values[i].choice.get_unsafe().emplace<array<double, 1>>()[0] = zero;
+        }
+
+        std::vector<char> bytes[2];
+        uint64_t digests[2];
+
+        for (int i = 0; i < 2; ++i)
+        {
+            canonical_scope scope;
+            iovec_list list;
+            assert(scope.gather(values[i], list));
+            digests[i] = scope.digest();
+
+            for (auto& [data, length] : list.get_segments())
+                bytes[i].insert(bytes[i].end(), static_cast<const char*>(data), static_cast<const char*>(data) + length);
+
+            size_t size;
+            assert(scope.serialize(values[i], first_buffer, sizeof(first_buffer), size = 0));
+            assert(bytes[i] == std::vector<char>(first_buffer, first_buffer + size));
+        }
+
+        assert(bytes[0] == bytes[1]);
+        assert(digests[0] == digests[1]);
+    }
+
+    class row final : public serializable
+    {
+    public:
+        virtual ~row() = default;
+        row() : serializable(member_vector) {}
+
+        member<double, member_type::DOUBLE> value;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&value)
+        };
+    };
+
+    // absent values of a column are zeros
+    columnar<row> first_rows;
+    columnar<row> second_rows;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        first_rows.push_back(std::make_unique<row>());
+        second_rows.push_back(std::make_unique<row>());
+        first_rows.back()->value.set(i % 2 ? double(i) : 1.0);
+        second_rows.back()->value.set(i % 2 ? double(i) : 2.0);
+        first_rows.back()->value.set_has_value(i % 2);
+        second_rows.back()->value.set_has_value(i % 2);
+    }
+
+    {
+        canonical_scope scope;
+        assert(scope.serialize(first_rows, first_buffer, sizeof(first_buffer), first_size = 0));
+        first_digest = scope.digest();
+    }
+
+    {
+        canonical_scope scope;
+        assert(scope.serialize(second_rows, second_buffer, sizeof(second_buffer), second_size = 0));
+        second_digest = scope.digest();
+    }
+
+    assert(first_size == second_size);
+    assert(0 == std::memcmp(first_buffer, second_buffer, first_size));
+    assert(first_digest == second_digest);
+    assert(xxh64::hash(first_buffer, first_size) == first_digest);
+
+    // the digest covers the final output only, gathering hashes the same bytes and a failed attempt adds nothing
+    {
+        canonical_scope scope;
+        assert(!scope.serialize(first, first_buffer, 8, first_size = 0));
+        assert(xxh64::hash(nullptr, 0) == scope.digest());
+        assert(scope.serialize(first, first_buffer, sizeof(first_buffer), first_size = 0));
+        first_digest = scope.digest();
+    }
+
+    {
+        canonical_scope scope;
+        iovec_list list(16);
+        list.copy("prefix", 6);
+        assert(scope.gather(first, list));
+        second_digest = scope.digest();
+    }
+
+    assert(first_digest == second_digest);
+    assert(xxh64::hash(first_buffer, first_size) == first_digest);
+}
@@ -0,0 +1,328 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+#include "srlz/array.hpp"
+#include "srlz/blob.hpp"
+#include "srlz/chunked.hpp"
+#include "srlz/map.hpp"
+#include "srlz/serializable.hpp"
+#include "srlz/string.hpp"
+#include "srlz/unordered_map.hpp"
+#include "srlz/variant.hpp"
+#include "srlz/vector.hpp"
+
+#ifdef SRLZ_COROUTINES
+
+void chunked_test()
+{
+    using namespace srlz;
+
+    constexpr size_t size = 10000ULL;
+
+    class item_entity final : public serializable
+    {
+    public:
+        virtual ~item_entity() = default;
+        item_entity() : serializable(member_vector) {}
+
+        member<int32_t, member_type::INT_32> i;
+        member<string, member_type::SRLZ> str;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&i),
+            static_cast<void*>(&str)
+        };
+    };
+
+    // a custom base type has no parts, so it is accumulated until deserialize succeeds
+    class opaque final : public base
+    {
+    public:
+        virtual bool serialize(
+            char* const buffer,
+            const size_t buffer_size,
+            size_t& buffer_offset
+            ) const override
+        {
+            return write(static_cast<const void*>(&value), sizeof(int64_t), buffer, buffer_size, buffer_offset);
+        }
+
+        virtual bool deserialize(
+            const char* const buffer,
+            const size_t buffer_size,
+            size_t& buffer_offset
+            ) const override
+        {
+            return read(static_cast<void*>(const_cast<int64_t*>(&value)), sizeof(int64_t), buffer, buffer_size, buffer_offset);
+        }
+
+        int64_t value = 0;
+    };
+
+    class entity final : public serializable
+    {
+    public:
+        virtual ~entity()
+        {
+            delete [] m.get_unsafe().pointer;
+        }
+
+        entity() : serializable(member_vector)
+        {
+            m.get_unsafe().size = size;
+            m.get_unsafe().pointer = new unsigned char[size];
+        }
+
+        member<map<int32_t, int64_t>, member_type::SRLZ> numbers;
+        member<int16_t, member_type::INT_16> i;
+        member<memory, member_type::SRLZ> m;
+        member<vector<item_entity>, member_type::SRLZ> v;
+        member<blob<>, member_type::SRLZ> b;
+        member<opaque, member_type::SRLZ> fallback;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&numbers),
+            static_cast<void*>(&i),
+            static_cast<void*>(&m),
+            static_cast<void*>(&v),
+            static_cast<void*>(&b),
+            static_cast<void*>(&fallback)
+        };
+    };
+
+    entity first;
+    first.i.set(15);
+    first.numbers.get_unsafe()[1] = 2;
+    first.numbers.get_unsafe()[3] = 4;
+    first.b.get_unsafe().resize(size);
+    first.fallback.get_unsafe().value = -5;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        first.m.get_unsafe().pointer[i] = static_cast<unsigned char>(i * 7);
+        first.b.get_unsafe().data()[i] = static_cast<unsigned char>(i * 3);
+    }
+
+    for (int32_t i = 0; i < 100; ++i)
+    {
+        first.v.get_unsafe().push_back(std::make_unique<item_entity>());
+        first.v.get().back()->i.set(i);
+        first.v.get().back()->str.get_unsafe().set(std::string(size_t(i), 'x'));
+    }
+
+    std::vector<char> buffer(5 * size);
+    size_t offset;
+    assert(first.serialize(buffer.data(), buffer.size(), offset = 0));
+    buffer.resize(offset);
+
+    constexpr size_t chunk_size = 100;
+
+    {
+        std::vector<char> joined;
+        size_t chunk_count = 0;
+
+        for (auto& [base, length] : encode_chunks(first, chunk_size))
+        {
+            assert(base);
+            assert(length == chunk_size || joined.size() + length == buffer.size());
+            joined.insert(joined.end(), static_cast<const char*>(base), static_cast<const char*>(base) + length);
+            ++chunk_count;
+        }
+
+        assert(joined == buffer);
+        assert((buffer.size() + chunk_size - 1) / chunk_size == chunk_count);
+    }
+
+    {
+        // the payload of a blob is yielded in place instead of being gathered
+        bool in_place = false;
+
+        for (auto& [base, length] : encode(first))
+            in_place = in_place || (base == first.b.get().data() && length == size);
+
+        assert(in_place);
+    }
+
+    for (size_t input_size : { size_t(1), size_t(3), size_t(4096) })
+    {
+        entity second;
+        decoder decoding(second);
+
+        for (size_t i = 0; i < buffer.size(); i += input_size)
+        {
+            const size_t length = std::min(input_size, buffer.size() - i);
+            assert(decoding.feed(buffer.data() + i, length) == (i + length == buffer.size()));
+        }
+
+        assert(decoding.success());
+        assert(0 == decoding.remaining());
+        assert(15 == second.i.get());
+        assert(4 == second.numbers.get().at(3));
+        assert(0 == std::memcmp(first.m.get().pointer, second.m.get().pointer, size));
+        assert(0 == std::memcmp(first.b.get().data(), second.b.get().data(), size));
+        assert(-5 == second.fallback.get().value);
+        assert(100 == second.v.get().size());
+        assert(99 == second.v.get().back()->i.get());
+        assert(99 == second.v.get().back()->str.get().length());
+    }
+
+    {
+        entity second;
+        decoder decoding(second);
+        assert(!decoding.feed(buffer.data(), buffer.size() / 2));
+        assert(!decoding.finish());
+        assert(decoding.done());
+        assert(!decoding.success());
+    }
+
+    {
+        // every srlz type streams the bytes serialize writes
+        class mixed final : public serializable
+        {
+        public:
+            virtual ~mixed() = default;
+            mixed() : serializable(member_vector) {}
+
+            member<array<float, 3>, member_type::SRLZ> a;
+            member<unordered_map<string, double, key_order::SORTED>, member_type::SRLZ> u;
+            member<variant<string, item_entity>, member_type::SRLZ> var;
+
+            serializable::member_vector_type member_vector =
+            {
+                static_cast<void*>(&a),
+                static_cast<void*>(&u),
+                static_cast<void*>(&var)
+            };
+        };
+
+        mixed source;
+        source.a.get_unsafe()[0] = 1.5f;
+        source.a.get_unsafe()[1] = -0.0f;
+        source.a.get_unsafe()[2] = 3.0f;
+
+        for (const char* key : { "b", "a", "c" })
+        {
+            string text;
+            text.set(key);
+            source.u.get_unsafe()[text] = double(key[0]);
+        }
+
+        source.var.get_unsafe().emplace<item_entity>().i.set(7);
+
+        std::vector<char> serialized(1024);
+        assert(source.serialize(serialized.data(), serialized.size(), offset = 0));
+        serialized.resize(offset);
+
+        std::vector<char> streamed;
+
+        for (auto& [base, length] : encode_chunks(source, 5))
+            streamed.insert(streamed.end(), static_cast<const char*>(base), static_cast<const char*>(base) + length);
+
+        assert(streamed == serialized);
+
+        mixed target;
+        decoder decoding(target);
+
+        for (size_t i = 0; i < streamed.size(); ++i)
+            decoding.feed(streamed.data() + i, 1);
+
+        assert(decoding.success());
+        assert(3.0f == target.a.get()[2]);
+        assert(3 == target.u.get().size());
+        assert(7 == target.var.get().get_if<item_entity>()->i.get());
+    }
+
+    {
+        // repeated strings are written as references and resolved while streaming
+        std::vector<char> written;
+        vector<string> words;
+
+        for (size_t i = 0; i < 10; ++i)
+        {
+            words.push_back(std::make_unique<string>());
+            words.back()->set(i % 2 ? "odd" : "even");
+        }
+
+        {
+            dictionary_scope scope;
+
+            for (auto& [base, length] : encode_chunks(words, 3))
+                written.insert(written.end(), static_cast<const char*>(base), static_cast<const char*>(base) + length);
+        }
+
+        std::vector<char> serialized(written.size());
+
+        {
+            dictionary_scope scope;
+            assert(words.serialize(serialized.data(), serialized.size(), offset = 0));
+            assert(written == serialized);
+        }
+
+        dictionary_scope scope;
+        vector<string> read;
+        decoder decoding(read);
+
+        for (size_t i = 0; i < written.size(); ++i)
+            decoding.feed(written.data() + i, 1);
+
+        assert(decoding.success());
+        assert(10 == read.size());
+        assert("odd" == std::string_view(*read[9]));
+    }
+
+    {
+        executor ex;
+        entity second;
+        decoder decoding(second);
+        std::string log;
+
+        auto pump = [](executor& ex, const entity& first, decoder& decoding, std::string& log) -> task
+        {
+            for (auto& [base, length] : encode_chunks(first, 4096))
+            {
+                decoding.feed(static_cast<const char*>(base), length);
+                log += 'c';
+                co_await ex.schedule();
+            }
+
+            co_return decoding.success();
+        };
+
+        auto other = [](executor& ex, std::string& log) -> task
+        {
+            for (size_t i = 0; i < 3; ++i)
+            {
+                log += 'o';
+                co_await ex.schedule();
+            }
+
+            co_return true;
+        };
+
+        ex.spawn(pump(ex, first, decoding, log));
+        ex.spawn(other(ex, log));
+        ex.run();
+
+        assert(decoding.success());
+        assert(log.substr(0, 6) == "cococo");
+        assert(0 == std::memcmp(first.m.get().pointer, second.m.get().pointer, size));
+    }
+}
+
+#else
+
+void chunked_test()
+{
+}
+
+#endif // SRLZ_COROUTINES
@@ -0,0 +1,153 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "srlz/columnar.hpp"
+#include "srlz/serializable.hpp"
+#include "srlz/vector.hpp"
+
+namespace columnar_test_entities
+{
+
+using namespace srlz;
+
+class item_entity final : public serializable
+{
+public:
+    virtual ~item_entity() = default;
+    item_entity() : serializable(member_vector) {}
+
+    member<uint8_t, member_type::U_INT_8> kind;
+    member<int64_t, member_type::INT_64> id;
+    member<double, member_type::DOUBLE> price;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&kind),
+        static_cast<void*>(&id),
+        static_cast<void*>(&price)
+    };
+};
+
+} // namespace columnar_test_entities
+
+void columnar_test()
+{
+    using namespace columnar_test_entities;
+
+    constexpr size_t count = 1000;
+
+    columnar<item_entity> first;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        first.push_back(std::make_unique<item_entity>());
+        first.back()->kind.set(uint8_t(i % 7));
+        first.back()->id.set(int64_t(i) * 3);
+        first.back()->price.set(double(i) / 4);
+        first.back()->price.set_has_value(i % 10 != 0);
+    }
+
+    // the buffer is aligned, so the columns are aligned in memory as well
+    std::vector<uint64_t> storage(count * 3);
+    char* const buffer = reinterpret_cast<char*>(storage.data());
+    const size_t buffer_size = storage.size() * sizeof(uint64_t);
+    size_t offset;
+
+    assert(first.serialize(buffer, buffer_size, offset = 0));
+    const size_t size = offset;
+
+    constexpr size_t bitmap_size = (count + 7) / 8;
+    assert(size >= sizeof(size_t) + 3 * (bitmap_size + 1) + count * (1 + 8 + 8));
+    assert(size <= sizeof(size_t) + 3 * (bitmap_size + 1 + 7) + count * (1 + 8 + 8));
+
+    {
+        columnar<item_entity> second;
+
+        assert(second.deserialize(buffer, size, offset = 0));
+        assert(size == offset);
+        assert(count == second.size());
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            assert(uint8_t(i % 7) == second[i]->kind.get());
+            assert(int64_t(i) * 3 == second[i]->id.get());
+            assert((i % 10 != 0) == second[i]->price.has_value());
+
+            if (second[i]->price.has_value())
+                assert(double(i) / 4 == second[i]->price.get());
+        }
+
+        // a smaller batch reuses the elements
+        const item_entity* const reused = second.front().get();
+        columnar<item_entity> small;
+        small.push_back(std::make_unique<item_entity>());
+        assert(small.serialize(buffer, buffer_size, offset = 0));
+        const size_t small_size = offset;
+        assert(second.deserialize(buffer, small_size, offset = 0));
+        assert(1 == second.size());
+        assert(reused == second.front().get());
+    }
+
+    assert(first.serialize(buffer, buffer_size, offset = 0));
+
+    {
+        columnar<item_entity>::view parsed;
+
+        assert(columnar<item_entity>::parse(buffer, size, offset = 0, parsed));
+        assert(size == offset);
+        assert(count == parsed.size());
+        assert(3 == parsed.get_member_count());
+        assert(parsed.column<double>(0).empty());
+
+        const auto ids = parsed.column<int64_t>(1);
+        const auto prices = parsed.column<double>(2);
+
+        assert(nullptr != ids.data());
+        assert(nullptr != prices.data());
+
+        int64_t id_sum = 0;
+        double price_sum = 0;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            id_sum += ids.data()[i];
+
+            if (prices.has_value(i))
+                price_sum += prices[i];
+        }
+
+        assert(int64_t(count * (count - 1) / 2 * 3) == id_sum);
+
+        double expected_price_sum = 0;
+
+        for (size_t i = 0; i < count; ++i)
+            if (i % 10 != 0)
+                expected_price_sum += double(i) / 4;
+
+        assert(expected_price_sum == price_sum);
+    }
+
+    {
+        columnar<item_entity> second;
+
+        assert(!second.deserialize(buffer, size - 1, offset = 0));
+    }
+
+    {
+        columnar<item_entity> empty;
+        columnar<item_entity> second;
+
+        assert(empty.serialize(buffer, buffer_size, offset = 0));
+        assert(sizeof(size_t) == offset);
+        assert(second.deserialize(buffer, sizeof(size_t), offset = 0));
+        assert(second.empty());
+    }
+}
@@ -6,6 +6,7 @@
  */
 
 #include <cassert>
+#include <cstring>
 #include <memory>
 #include <vector>
 
@@ -16,8 +17,6 @@ void custom_entity_test()
 {
     using namespace srlz;
 
-    constexpr size_t size = size_t(512);
-
     class entity final : public serializable
     {
     public:
@@ -31,6 +30,11 @@ void custom_entity_test()
 
         std::unique_ptr<std::vector<int32_t>> custom_vector { new std::vector<int32_t>() };
 
+        virtual bool overrides_serialize() const noexcept override
+        {
+            return true;
+        }
+
         virtual bool serialize(
             char* const buffer,
             const size_t buffer_size,
@@ -39,11 +43,11 @@ void custom_entity_test()
         {
             size_t length = custom_vector->size();
 
-            if (!write(static_cast<const void* const>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
+            if (!write(static_cast<const void*>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
                 return false;
 
             for (auto& item : *custom_vector)
-                if (!write(static_cast<const void* const>(&item), sizeof(item), buffer, buffer_size, buffer_offset))
+                if (!write(static_cast<const void*>(&item), sizeof(item), buffer, buffer_size, buffer_offset))
                     return false;
 
             return serializable::serialize(buffer, buffer_size, buffer_offset);
@@ -59,14 +63,14 @@ void custom_entity_test()
 
             size_t length;
 
-            if (!read(static_cast<void* const>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
+            if (!read(static_cast<void*>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
                 return false;
 
             for (size_t i = 0; i < length; ++i)
             {
                 int32_t value;
 
-                if (!read(static_cast<void* const>(&value), sizeof(value), buffer, buffer_size, buffer_offset))
+                if (!read(static_cast<void*>(&value), sizeof(value), buffer, buffer_size, buffer_offset))
                     return false;
 
                 custom_vector->push_back(value);
@@ -93,5 +97,65 @@ void custom_entity_test()
     assert((*second.custom_vector)[0] == test_value);
     assert((*second.custom_vector)[1] == test_value + 5);
 
+    // an entity which overrides serialize is gathered through it
+    iovec_list list;
+    assert(first.gather(list));
+    assert(expected_size == list.size());
+
+    std::vector<char> joined;
+
+    for (auto& [base, length] : list.get_segments())
+        joined.insert(joined.end(), static_cast<const char*>(base), static_cast<const char*>(base) + length);
+
+    assert(0 == std::memcmp(buffer, joined.data(), expected_size));
+
+    // an override which writes nothing for the first instance still writes for the next ones
+    class trailed final : public serializable
+    {
+    public:
+        virtual ~trailed() = default;
+        trailed() : serializable(member_vector) {}
+
+        member<int32_t, member_type::INT_32> i;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&i)
+        };
+
+        std::vector<char> trailer;
+
+        virtual bool overrides_serialize() const noexcept override
+        {
+            return true;
+        }
+
+        virtual bool serialize(
+            char* const buffer,
+            const size_t buffer_size,
+            size_t& buffer_offset
+            ) const override
+        {
+            if (!serializable::serialize(buffer, buffer_size, buffer_offset))
+                return false;
+
+            return trailer.empty() || write(static_cast<const void*>(trailer.data()), trailer.size(), buffer, buffer_size, buffer_offset);
+        }
+    };
+
+    for (const size_t trailer_size : { size_t(0), size_t(12) })
+    {
+        trailed value;
+        value.i.set(1);
+        value.trailer.assign(trailer_size, 't');
+
+        char serialized[64];
+        assert(value.serialize(serialized, sizeof(serialized), offset = 0));
+
+        iovec_list trailed_list;
+        assert(value.gather(trailed_list));
+        assert(offset == trailed_list.size());
+    }
+
     //debug_helper(buffer, serialize_offset);
 }
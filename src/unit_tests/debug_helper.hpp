@@ -12,10 +12,10 @@
 
 void debug_helper(char* buffer, size_t length)
 {
-    printf("buffer length: %llu\n", length);
+    printf("buffer length: %zu\n", length);
 
     for (size_t i = 0; i < length; ++i)
-        printf("buffer[%llu]\t%hhu\n", i, (uint8_t)*(buffer + i));
+        printf("buffer[%zu]\t%hhu\n", i, (uint8_t)*(buffer + i));
 }
 
 #endif // SRLZ_UNIT_TESTS_DEBUG_HELPER_HPP
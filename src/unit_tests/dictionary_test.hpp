@@ -0,0 +1,172 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+#include "srlz/dictionary.hpp"
+#include "srlz/map.hpp"
+#include "srlz/serializable.hpp"
+#include "srlz/string.hpp"
+#include "srlz/vector.hpp"
+
+void dictionary_test()
+{
+    using namespace std::string_literals;
+
+    using namespace srlz;
+
+    class record final : public serializable
+    {
+    public:
+        virtual ~record() = default;
+        record() : serializable(member_vector) {}
+
+        member<string, member_type::SRLZ> host;
+        member<string, member_type::SRLZ> symbol;
+        member<int64_t, member_type::INT_64> value;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&host),
+            static_cast<void*>(&symbol),
+            static_cast<void*>(&value)
+        };
+    };
+
+    const std::string hosts[] = { "frontend-01.example.com"s, "frontend-02.example.com"s, "backend-01.example.com"s };
+    const std::string symbols[] = { "EURUSD"s, "GBPUSD"s, "USDJPY"s, "XAUUSD"s };
+    constexpr size_t count = 1000;
+
+    vector<record> batch;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        batch.push_back(batch.make_item());
+        batch.back()->host.get_unsafe().set(hosts[i % 3]);
+        batch.back()->symbol.get_unsafe().set(symbols[i % 4]);
+        batch.back()->value.set(int64_t(i));
+    }
+
+    std::vector<char> plain(64 * 1024);
+    std::vector<char> encoded(64 * 1024);
+    size_t plain_size;
+    size_t encoded_size;
+
+    assert(batch.serialize(plain.data(), plain.size(), plain_size = 0));
+
+    {
+        dictionary_scope scope;
+        assert(batch.serialize(encoded.data(), encoded.size(), encoded_size = 0));
+        assert(7 == scope.size());
+    }
+
+    // each repeated string is a 4 byte reference instead of a length and the characters
+    assert(encoded_size * 2 < plain_size);
+
+    {
+        dictionary_scope scope;
+        vector<record> decoded;
+        size_t offset;
+
+        assert(decoded.deserialize(encoded.data(), encoded_size, offset = 0));
+        assert(encoded_size == offset);
+        assert(count == decoded.size());
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            assert(hosts[i % 3] == decoded[i]->host.get());
+            assert(symbols[i % 4] == decoded[i]->symbol.get());
+            assert(int64_t(i) == decoded[i]->value.get());
+        }
+    }
+
+    {
+        // a reader without the dictionary state of the batch rejects references
+        char buffer[256];
+        size_t offset;
+        size_t first_size;
+
+        {
+            dictionary_scope scope;
+            assert(batch[0]->serialize(buffer, sizeof(buffer), offset = 0));
+            first_size = offset;
+            assert(batch[3]->serialize(buffer, sizeof(buffer), offset));
+        }
+
+        dictionary_scope scope;
+        record single;
+
+        assert(!single.deserialize(buffer + first_size, sizeof(buffer) - first_size, offset = 0));
+    }
+
+    {
+        // long values are written but not interned
+        string first;
+        first.set(std::string(300, 'x'));
+        char buffer[1024];
+        size_t offset;
+
+        dictionary_scope writer;
+        assert(first.serialize(buffer, sizeof(buffer), offset = 0));
+        assert(first.serialize(buffer, sizeof(buffer), offset));
+        assert(2 * (sizeof(uint32_t) + 300) == offset);
+        assert(0 == writer.size());
+
+        {
+            dictionary_scope reader;
+            string second;
+            assert(second.deserialize(buffer, sizeof(buffer), offset = 0));
+            assert(second.deserialize(buffer, sizeof(buffer), offset));
+            assert(first == second);
+            assert(0 == reader.size());
+        }
+
+        // scopes nest and the innermost one applies
+        assert(&writer == dictionary_scope::get());
+    }
+
+    {
+        // a retry in a larger buffer does not keep the entries of the failed attempt
+        map<int32_t, string> values;
+
+        for (int32_t i = 0; i < 8; ++i)
+            values[i].set(std::string(20, char('a' + i)));
+
+        std::vector<char> serialized(1024);
+        size_t serialized_size;
+
+        {
+            dictionary_scope scope;
+            assert(values.serialize(serialized.data(), serialized.size(), serialized_size = 0));
+        }
+
+        iovec_list list;
+
+        {
+            dictionary_scope scope;
+            assert(values.gather(list));
+            assert(8 == scope.size());
+        }
+
+        std::vector<char> joined;
+
+        for (auto& [base, length] : list.get_segments())
+            joined.insert(joined.end(), static_cast<const char*>(base), static_cast<const char*>(base) + length);
+
+        assert(joined == std::vector<char>(serialized.begin(), serialized.begin() + long(serialized_size)));
+
+        dictionary_scope scope;
+        map<int32_t, string> decoded;
+        size_t offset;
+        assert(decoded.deserialize(joined.data(), joined.size(), offset = 0));
+        assert(values == decoded);
+    }
+
+    assert(nullptr == dictionary_scope::get());
+}
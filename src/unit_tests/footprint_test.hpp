@@ -0,0 +1,130 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+
+#include "srlz/blob.hpp"
+#include "srlz/map.hpp"
+#include "srlz/serializable.hpp"
+#include "srlz/string.hpp"
+#include "srlz/variant.hpp"
+#include "srlz/vector.hpp"
+
+void footprint_test()
+{
+    using namespace srlz;
+
+    class nested_entity final : public serializable
+    {
+    public:
+        virtual ~nested_entity() = default;
+        nested_entity() : serializable(member_vector) {}
+
+        member<int64_t, member_type::INT_64> i;
+        member<string, member_type::SRLZ> str;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&i),
+            static_cast<void*>(&str)
+        };
+    };
+
+    class entity final : public serializable
+    {
+    public:
+        virtual ~entity() = default;
+        entity() : serializable(member_vector) {}
+
+        member<int32_t, member_type::INT_32> i;
+        member<string, member_type::SRLZ> str;
+        member<vector<nested_entity>, member_type::SRLZ> v;
+        member<map<int32_t, string>, member_type::SRLZ> m;
+        member<blob<>, member_type::SRLZ> b;
+        member<variant<string, nested_entity>, member_type::SRLZ> var;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&i),
+            static_cast<void*>(&str),
+            static_cast<void*>(&v),
+            static_cast<void*>(&m),
+            static_cast<void*>(&b),
+            static_cast<void*>(&var)
+        };
+    };
+
+    const std::string long_text(100, 'x');
+
+    {
+        string short_string;
+        short_string.set("short");
+        assert(footprint{} == short_string.get_footprint());
+
+        string long_string;
+        long_string.set(long_text);
+        assert((footprint{ 1, long_string.capacity() + 1 }) == long_string.get_footprint());
+    }
+
+    entity value;
+
+    // every member is allocated, containers are empty
+    const footprint empty = value.get_footprint();
+    assert(6 + 1 == empty.allocations);
+    assert((footprint{ 1, sizeof(int32_t) }) == value.get_member_footprint(0));
+    assert((footprint{ 1, sizeof(string) }) == value.get_member_footprint(1));
+    assert((footprint{ 2, sizeof(variant<string, nested_entity>) + sizeof(string) }) == value.get_member_footprint(5));
+
+    value.str.get_unsafe().set(long_text);
+    assert((footprint{ 2, sizeof(string) + value.str.get().capacity() + 1 }) == value.get_member_footprint(1));
+
+    // an element of a vector takes its pointer, the element and its members
+    auto& v = value.v.get_unsafe();
+    v.reserve(4);
+
+    for (int i = 0; i < 3; ++i)
+        v.push_back(v.make_item());
+
+    v.back()->str.get_unsafe().set(long_text);
+
+    const footprint element { 2, sizeof(int64_t) + sizeof(string) };
+    const footprint elements = footprint{ 1, 4 * sizeof(vector<nested_entity>::pointer_type) }
+        + footprint{ 3 * (1 + element.allocations), 3 * (sizeof(nested_entity) + element.bytes) }
+        + v.back()->str.get().get_footprint();
+
+    assert((footprint{ 1, sizeof(vector<nested_entity>) } + elements == value.get_member_footprint(2)));
+
+    // a map node and the heap memory of its value
+    value.m.get_unsafe()[1].set(long_text);
+    assert(2 == value.m.get().get_footprint().allocations);
+    assert(value.m.get().get_footprint().bytes > sizeof(string) + long_text.size());
+
+    value.b.get_unsafe().resize(100);
+    assert((footprint{ 1, value.b.get().capacity() }) == value.b.get().get_footprint());
+
+    value.var.get_unsafe().emplace<nested_entity>();
+    assert((footprint{ 1 + 1 + element.allocations, sizeof(variant<string, nested_entity>) + sizeof(nested_entity) + element.bytes })
+        == value.get_member_footprint(5));
+
+    footprint total;
+
+    for (size_t i = 0; i < value.get_member_count(); ++i)
+        total += value.get_member_footprint(i);
+
+    assert(total == value.get_footprint());
+
+    // the cache is allocated once it is enabled
+    value.enable_cache();
+    assert(total.allocations + 1 == value.get_footprint().allocations);
+
+    // the cached bytes are owned by the entity
+    char buffer[1024];
+    size_t offset = 0;
+    assert(value.serialize(buffer, sizeof(buffer), offset));
+    assert(total.allocations + 1 + 2 == value.get_footprint().allocations);
+    assert(total.bytes + offset <= value.get_footprint().bytes);
+}
@@ -0,0 +1,118 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "srlz/framed.hpp"
+#include "srlz/serializable.hpp"
+#include "srlz/string.hpp"
+
+void framed_test()
+{
+    using namespace srlz;
+
+    class event final : public serializable
+    {
+    public:
+        virtual ~event() = default;
+        event() : serializable(member_vector) {}
+
+        member<int32_t, member_type::INT_32> id;
+        member<string, member_type::SRLZ> text;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&id),
+            static_cast<void*>(&text)
+        };
+    };
+
+    std::vector<char> first;
+    std::vector<char> second;
+
+    {
+        framed_writer writer(first);
+        event record;
+
+        for (int32_t i = 0; i < 100; ++i)
+        {
+            record.id.set(i);
+            record.text.get_unsafe().set(std::string(size_t(i) * 3, 'a'));
+            assert(writer.append(record));
+        }
+    }
+
+    // an empty buffer has no records
+    assert(framed_range(nullptr, 0).begin() == framed_range(nullptr, 0).end());
+
+    // records are read in place into one entity
+    {
+        const framed_range range(first);
+        event record;
+        int32_t expected = 0;
+
+        for (const record_view& view : range)
+        {
+            assert(view.data > first.data() && view.data + view.size <= first.data() + first.size());
+            assert(view.deserialize(record));
+            assert(expected == record.id.get());
+            assert(size_t(expected) * 3 == record.text.get().size());
+            ++expected;
+        }
+
+        assert(100 == expected);
+        assert(first.size() == range.valid_size());
+    }
+
+    // records are skipped without deserializing, views are copied into another buffer
+    {
+        framed_writer writer(second);
+        const framed_range range(first);
+        auto it = range.begin();
+        std::advance(it, 98);
+
+        for (; it != range.end(); ++it)
+            assert(writer.append(*it));
+
+        assert(2 == std::distance(framed_range(second).begin(), framed_range(second).end()));
+    }
+
+    // concatenated buffers are one framed buffer
+    std::vector<char> joined(first);
+    joined.insert(joined.end(), second.begin(), second.end());
+    assert(102 == std::distance(framed_range(joined).begin(), framed_range(joined).end()));
+
+    {
+        event record;
+        framed_range range(joined);
+        auto it = range.begin();
+        std::advance(it, 101);
+        assert(it->deserialize(record));
+        assert(99 == record.id.get());
+    }
+
+    // an incomplete record ends the range and stays outside the valid size
+    const size_t cut = joined.size() - 5;
+    const framed_range truncated(joined.data(), cut);
+    assert(101 == std::distance(truncated.begin(), truncated.end()));
+    assert(cut > truncated.valid_size() && first.size() + sizeof(uint32_t) < truncated.valid_size());
+
+    // a length which does not match the record fails to deserialize
+    {
+        std::vector<char> broken(first.begin(), first.begin() + long(framed_range(first).begin()->size + sizeof(uint32_t)));
+        broken.push_back(0);
+        const uint32_t length = uint32_t(broken.size() - sizeof(uint32_t));
+        std::memcpy(broken.data(), &length, sizeof(uint32_t));
+
+        event record;
+        assert(!framed_range(broken).begin()->deserialize(record));
+    }
+}
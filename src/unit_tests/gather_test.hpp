@@ -0,0 +1,148 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+#ifdef __unix__
+#include <unistd.h>
+#endif
+
+#include "debug_helper.hpp"
+#include "srlz/iovec_list.hpp"
+#include "srlz/map.hpp"
+#include "srlz/serializable.hpp"
+#include "srlz/string.hpp"
+#include "srlz/vector.hpp"
+
+void gather_test()
+{
+    using namespace srlz;
+
+    constexpr size_t size = 4096ULL;
+
+    class item_entity final : public serializable
+    {
+    public:
+        virtual ~item_entity() = default;
+        item_entity() : serializable(member_vector) {}
+
+        member<int32_t, member_type::INT_32> i;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&i)
+        };
+    };
+
+    class entity final : public serializable
+    {
+    public:
+        virtual ~entity()
+        {
+            delete [] m.get_unsafe().pointer;
+        }
+
+        entity() : serializable(member_vector)
+        {
+            m.get_unsafe().size = size;
+            m.get_unsafe().pointer = new unsigned char[size];
+        }
+
+        member<int64_t, member_type::INT_64> i;
+        member<memory, member_type::SRLZ> m;
+        member<string, member_type::SRLZ> str;
+        member<string, member_type::SRLZ> short_str;
+        member<vector<item_entity>, member_type::SRLZ> v;
+        member<map<int32_t, int32_t>, member_type::SRLZ> fallback;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&i),
+            static_cast<void*>(&m),
+            static_cast<void*>(&str),
+            static_cast<void*>(&short_str),
+            static_cast<void*>(&v),
+            static_cast<void*>(&fallback)
+        };
+    };
+
+    entity first;
+    first.i.set(15);
+
+    for (size_t i = 0; i < size; ++i)
+        first.m.get_unsafe().pointer[i] = static_cast<unsigned char>(i);
+
+    first.str.get_unsafe().set(std::string(1024, 's'));
+    first.short_str.get_unsafe().set("short");
+
+    for (int32_t i = 0; i < 3; ++i)
+    {
+        first.v.get_unsafe().push_back(std::make_unique<item_entity>());
+        first.v.get().back()->i.set(i);
+    }
+
+    first.fallback.get_unsafe()[1] = 2;
+
+    std::vector<char> buffer(2 * size);
+    size_t offset;
+    assert(first.serialize(buffer.data(), buffer.size(), offset = 0));
+    buffer.resize(offset);
+
+    iovec_list list;
+    assert(first.gather(list));
+    assert(buffer.size() == list.size());
+
+    auto& segments = list.get_segments();
+
+    // has_value and size of m, the blob, the string length, the string, everything else
+    assert(5 == segments.size());
+    assert(first.m.get().pointer == segments[1].base);
+    assert(size == segments[1].length);
+    assert(first.str.get().data() == segments[3].base);
+    assert(first.str.get().length() == segments[3].length);
+
+    std::vector<char> joined;
+
+    for (auto& [base, length] : segments)
+        joined.insert(joined.end(), static_cast<const char*>(base), static_cast<const char*>(base) + length);
+
+    assert(joined == buffer);
+
+#ifdef __unix__
+    {
+        int fds[2];
+        assert(0 == pipe(fds));
+
+        auto iovecs = list.get_iovecs();
+        assert(ssize_t(buffer.size()) == writev(fds[1], iovecs.data(), int(iovecs.size())));
+        close(fds[1]);
+
+        std::vector<char> received(buffer.size());
+        size_t received_size = 0;
+
+        for (ssize_t count; (count = read(fds[0], received.data() + received_size, received.size() - received_size)) > 0;)
+            received_size += size_t(count);
+
+        close(fds[0]);
+        assert(received == buffer);
+
+        entity second;
+        assert(second.deserialize(received.data(), received.size(), offset = 0));
+        assert(received.size() == offset);
+        assert(first.str.get() == second.str.get());
+        assert(0 == std::memcmp(first.m.get().pointer, second.m.get().pointer, size));
+    }
+#endif
+
+    list.clear();
+    assert(0 == list.size());
+    assert(list.get_segments().empty());
+
+    //debug_helper(buffer.data(), offset);
+}
@@ -0,0 +1,214 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+#include "srlz/array.hpp"
+#include "srlz/chunked.hpp"
+#include "srlz/limits.hpp"
+#include "srlz/map.hpp"
+#include "srlz/memory.h"
+#include "srlz/serializable.hpp"
+#include "srlz/string.hpp"
+#include "srlz/vector.hpp"
+
+namespace limits_test_entities
+{
+
+using namespace srlz;
+
+class node final : public serializable
+{
+public:
+    virtual ~node() = default;
+    node() : serializable(member_vector) {}
+
+    member<vector<node>, member_type::SRLZ> children;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&children)
+    };
+};
+
+class empty final : public serializable
+{
+public:
+    virtual ~empty() = default;
+    empty() : serializable(member_vector) {}
+
+    serializable::member_vector_type member_vector;
+};
+
+} // namespace limits_test_entities
+
+void limits_test()
+{
+    using namespace std::string_literals;
+
+    using namespace limits_test_entities;
+
+    constexpr size_t huge_length = std::numeric_limits<size_t>::max() / 2;
+    char buffer[256];
+    size_t offset;
+
+    {
+        string str;
+        std::memcpy(buffer, &huge_length, sizeof(size_t));
+
+        assert(!str.deserialize(buffer, sizeof(buffer), offset = 0));
+        assert(str.empty());
+
+        vector<string> v;
+
+        assert(!v.deserialize(buffer, sizeof(buffer), offset = 0));
+        assert(v.empty());
+
+        map<int32_t, int32_t> m;
+
+        assert(!m.deserialize(buffer, sizeof(buffer), offset = 0));
+
+        // an offset past the end of the buffer is not an overflow
+        assert(!str.deserialize(buffer, sizeof(buffer), offset = sizeof(buffer) + 1));
+        assert(!str.serialize(buffer, sizeof(buffer), offset = std::numeric_limits<size_t>::max()));
+    }
+
+    {
+        unsigned char source_data[16] = {};
+        unsigned char target_data[8] = {};
+        memory source;
+        source.pointer = source_data;
+        source.size = sizeof(source_data);
+        memory target;
+        target.pointer = target_data;
+        target.size = sizeof(target_data);
+
+        assert(source.serialize(buffer, sizeof(buffer), offset = 0));
+        assert(!target.deserialize(buffer, sizeof(buffer), offset = 0));
+        assert(sizeof(target_data) == target.size);
+
+        source.size = 4;
+        assert(source.serialize(buffer, sizeof(buffer), offset = 0));
+        assert(target.deserialize(buffer, sizeof(buffer), offset = 0));
+        assert(4 == target.size);
+
+        // a smaller value does not shrink the capacity
+        source.size = 8;
+        assert(source.serialize(buffer, sizeof(buffer), offset = 0));
+        assert(target.deserialize(buffer, sizeof(buffer), offset = 0));
+        assert(8 == target.size && sizeof(target_data) == target.capacity);
+    }
+
+    {
+        string first;
+        first.set("sixteen bytes!!!"s);
+
+        assert(first.serialize(buffer, sizeof(buffer), offset = 0));
+
+        string second;
+
+        {
+            limits_scope scope({ 15 });
+            assert(!second.deserialize(buffer, sizeof(buffer), offset = 0));
+        }
+
+        {
+            limits_scope scope({ std::numeric_limits<size_t>::max(), 15 });
+            assert(!second.deserialize(buffer, sizeof(buffer), offset = 0));
+        }
+
+        {
+            limits_scope scope({ 40 });
+            assert(second.deserialize(buffer, sizeof(buffer), offset = 0));
+            assert(16 == scope.get_allocated());
+            assert(second.deserialize(buffer, sizeof(buffer), offset = 0));
+            assert(32 == scope.get_allocated());
+            assert(!second.deserialize(buffer, sizeof(buffer), offset = 0));
+        }
+
+        assert(second.deserialize(buffer, sizeof(buffer), offset = 0));
+        assert(first == second);
+    }
+
+    {
+        node root;
+        node* current = &root;
+
+        for (int depth = 0; depth < 10; ++depth)
+        {
+            current->children.get_unsafe().push_back(std::make_unique<node>());
+            current = current->children.get().back().get();
+        }
+
+        current->children.set_has_value(false);
+
+        assert(root.serialize(buffer, sizeof(buffer), offset = 0));
+        const size_t size = offset;
+
+        node second;
+
+        {
+            limits_scope scope({ std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max(), 10 });
+            assert(!second.deserialize(buffer, size, offset = 0));
+        }
+
+        {
+            limits_scope scope({ std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max(), 11 });
+            assert(second.deserialize(buffer, size, offset = 0));
+            assert(size == offset);
+        }
+    }
+
+    // elements which take no bytes pass the length check, a length beyond the bytes of fixed size elements does not
+    {
+        vector<empty> empties;
+
+        for (int i = 0; i < 3; ++i)
+            empties.push_back(std::make_unique<empty>());
+
+        vector<array<int32_t, 0>> arrays;
+        arrays.push_back(std::make_unique<array<int32_t, 0>>());
+
+        char buffer[2 * sizeof(size_t)];
+        size_t offset;
+
+        assert(empties.serialize(buffer, sizeof(buffer), offset = 0));
+        assert(arrays.serialize(buffer, sizeof(buffer), offset));
+        assert(sizeof(buffer) == offset);
+
+        vector<empty> empties_copy;
+        vector<array<int32_t, 0>> arrays_copy;
+        assert(empties_copy.deserialize(buffer, sizeof(buffer), offset = 0));
+        assert(3 == empties_copy.size());
+        assert(arrays_copy.deserialize(buffer, sizeof(buffer), offset));
+        assert(1 == arrays_copy.size());
+
+        const size_t length = 2;
+        char short_input[sizeof(size_t) + sizeof(int64_t)];
+        std::memcpy(short_input, &length, sizeof(size_t));
+
+        vector<array<int64_t, 1>> numbers;
+        assert(!numbers.deserialize(short_input, sizeof(short_input), offset = 0));
+    }
+
+#ifdef SRLZ_COROUTINES
+    // a streamed payload is read in slices which grow with the bytes which have arrived, a claimed length is not allocated up front
+    {
+        char input[sizeof(size_t) + 16] = {};
+        const size_t length = std::numeric_limits<size_t>::max() / 2;
+        std::memcpy(input, &length, sizeof(size_t));
+
+        string target;
+        decoder decoding(target);
+        assert(!decoding.feed(input, sizeof(input)));
+        assert(!decoding.finish());
+        assert(target.capacity() <= 4096);
+    }
+#endif // SRLZ_COROUTINES
+}
@@ -0,0 +1,139 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <cstring>
+
+#include "debug_helper.hpp"
+#include "srlz/map.hpp"
+#include "srlz/serializable.hpp"
+#include "srlz/string.hpp"
+#include "srlz/unordered_map.hpp"
+
+void map_test()
+{
+    using namespace std::string_literals;
+
+    using namespace srlz;
+
+    class value_entity final : public serializable
+    {
+    public:
+        virtual ~value_entity() = default;
+        value_entity() : serializable(member_vector) {}
+
+        member<int32_t, member_type::INT_32> i;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&i)
+        };
+    };
+
+    class entity final : public serializable
+    {
+    public:
+        virtual ~entity() = default;
+        entity() : serializable(member_vector) {}
+
+        member<map<int32_t, string>, member_type::SRLZ> m;
+        member<unordered_map<string, value_entity>, member_type::SRLZ> um;
+        member<unordered_map<uint16_t, double, key_order::SORTED>, member_type::SRLZ> sorted;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&m),
+            static_cast<void*>(&um),
+            static_cast<void*>(&sorted)
+        };
+    };
+
+    constexpr int32_t test_value = 15;
+    entity first;
+    entity second;
+
+    first.m.get_unsafe()[test_value + 1].set("second"s);
+    first.m.get_unsafe()[test_value].set("first"s);
+
+    string key;
+    key.set("key"s);
+    first.um.get_unsafe()[key].i.set(test_value);
+    key.set("other key"s);
+    first.um.get_unsafe()[key].i.set(test_value + 1);
+
+    for (uint16_t i = 0; i < 64; ++i)
+        first.sorted.get_unsafe()[uint16_t(i * 7 % 64)] = i;
+
+    second.m.get_unsafe()[0].set("stale"s);
+
+    const size_t expected_size =
+        sizeof(bool) + sizeof(size_t) +
+        (sizeof(int32_t) + sizeof(size_t)) * 2 + "second"s.length() + "first"s.length() +
+        sizeof(bool) + sizeof(size_t) +
+        sizeof(size_t) * 2 + "key"s.length() + "other key"s.length() + (sizeof(bool) + sizeof(int32_t)) * 2 +
+        sizeof(bool) + sizeof(size_t) +
+        (sizeof(uint16_t) + sizeof(double)) * 64;
+
+    char buffer[expected_size];
+    size_t offset;
+
+    assert(first.serialize(buffer, expected_size, offset = 0));
+    assert(expected_size == offset);
+    assert(second.deserialize(buffer, expected_size, offset = 0));
+    assert(expected_size == offset);
+
+    assert(2 == second.m.get().size());
+    assert("first"s == second.m.get().at(test_value));
+    assert("second"s == second.m.get().at(test_value + 1));
+
+    assert(2 == second.um.get().size());
+    key.set("key"s);
+    assert(test_value == second.um.get().at(key).i.get());
+    key.set("other key"s);
+    assert(test_value + 1 == second.um.get().at(key).i.get());
+
+    assert(64 == second.sorted.get().size());
+    for (uint16_t i = 0; i < 64; ++i)
+        assert(i == second.sorted.get().at(uint16_t(i * 7 % 64)));
+
+    {
+        unordered_map<uint16_t, double, key_order::SORTED> forward;
+        unordered_map<uint16_t, double, key_order::SORTED> backward;
+
+        for (uint16_t i = 0; i < 64; ++i)
+        {
+            forward[i] = i;
+            backward[uint16_t(63 - i)] = 63 - i;
+        }
+
+        constexpr size_t size = sizeof(size_t) + (sizeof(uint16_t) + sizeof(double)) * 64;
+        char forward_buffer[size];
+        char backward_buffer[size];
+
+        assert(forward.serialize(forward_buffer, size, offset = 0));
+        assert(backward.serialize(backward_buffer, size, offset = 0));
+        assert(0 == std::memcmp(forward_buffer, backward_buffer, size));
+
+        uint16_t previous;
+        std::memcpy(&previous, forward_buffer + sizeof(size_t), sizeof(uint16_t));
+
+        for (size_t i = 1; i < 64; ++i)
+        {
+            uint16_t current;
+            std::memcpy(&current, forward_buffer + sizeof(size_t) + (sizeof(uint16_t) + sizeof(double)) * i, sizeof(uint16_t));
+            assert(previous < current);
+            previous = current;
+        }
+    }
+
+    {
+        map<int32_t, string> truncated;
+        assert(!truncated.deserialize(buffer, sizeof(bool) + sizeof(size_t) + sizeof(int32_t), offset = sizeof(bool)));
+    }
+
+    //debug_helper(buffer, serialize_offset);
+}
@@ -0,0 +1,331 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "srlz/mapped_store.hpp"
+#include "srlz/serializable.hpp"
+#include "srlz/string.hpp"
+#include "srlz/vector.hpp"
+
+namespace mapped_store_test_entities
+{
+
+using namespace srlz;
+
+class account final : public serializable
+{
+public:
+    virtual ~account() = default;
+    account() : serializable(member_vector) {}
+
+    member<bool, member_type::BOOL> active;
+    member<string, member_type::SRLZ> name;
+    member<int64_t, member_type::INT_64> counter;
+    member<double, member_type::DOUBLE> balance;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&active),
+        static_cast<void*>(&name),
+        static_cast<void*>(&counter),
+        static_cast<void*>(&balance)
+    };
+};
+
+class other final : public serializable
+{
+public:
+    virtual ~other() = default;
+    other() : serializable(member_vector) {}
+
+    member<int32_t, member_type::INT_32> value;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&value)
+    };
+};
+
+class named final : public serializable
+{
+public:
+    virtual ~named() = default;
+    named() : serializable(member_vector) {}
+
+    member<string, member_type::SRLZ> value;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&value)
+    };
+};
+
+class listed final : public serializable
+{
+public:
+    virtual ~listed() = default;
+    listed() : serializable(member_vector) {}
+
+    member<vector<string>, member_type::SRLZ> value;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&value)
+    };
+};
+
+class other_list final : public serializable
+{
+public:
+    virtual ~other_list() = default;
+    other_list() : serializable(member_vector) {}
+
+    member<vector<other>, member_type::SRLZ> value;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&value)
+    };
+};
+
+class named_list final : public serializable
+{
+public:
+    virtual ~named_list() = default;
+    named_list() : serializable(member_vector) {}
+
+    member<vector<named>, member_type::SRLZ> value;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&value)
+    };
+};
+
+class tree final : public serializable
+{
+public:
+    virtual ~tree() = default;
+    tree() : serializable(member_vector) {}
+
+    member<int32_t, member_type::INT_32> value;
+    member<vector<tree>, member_type::SRLZ> children;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&value),
+        static_cast<void*>(&children)
+    };
+};
+
+class oversized final : public serializable
+{
+public:
+    virtual ~oversized() = default;
+
+    oversized() : serializable(member_vector)
+    {
+        fitting.get_unsafe().set("fits");
+        value.get_unsafe().set(std::string(64 * 1024, 'o'));
+    }
+
+    member<string, member_type::SRLZ> fitting;
+    member<string, member_type::SRLZ> value;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&fitting),
+        static_cast<void*>(&value)
+    };
+};
+
+} // namespace mapped_store_test_entities
+
+void mapped_store_test()
+{
+    using namespace srlz;
+    using namespace mapped_store_test_entities;
+
+    char path[] = "/tmp/srlz_mapped_store_XXXXXX";
+    const int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+
+    const std::string long_name(1000, 'n');
+
+    {
+        auto store = mapped_store<account>::open(path, 3);
+        assert(store);
+        assert(0 == store->size() && 3 == store->capacity());
+
+        for (int64_t i = 0; i < 3; ++i)
+        {
+            account* const record = store->append();
+            assert(record);
+            record->active.set(true);
+            record->name.get_unsafe().set("account " + std::to_string(i));
+            record->counter.set(i);
+            record->balance.set(0.5 * double(i));
+        }
+
+        assert(!store->append());
+        assert(store->checkpoint());
+
+        // a fixed member is changed in the file without a store
+        (*store)[1].counter.set(100);
+        ++(*store)[2].counter.get_unsafe();
+
+        // so is has_value
+        (*store)[2].balance.set_has_value(false);
+
+        // a srlz member outgrows its place and is relocated
+        (*store)[0].name.get_unsafe().set(long_name);
+        assert(store->store(0));
+    }
+
+    assert(!mapped_store<other>::open(path, 3));
+
+    {
+        auto store = mapped_store<account>::open(path, 10);
+        assert(store);
+        assert(3 == store->size() && 3 == store->capacity());
+
+        assert(long_name == std::string_view((*store)[0].name.get()));
+        assert("account 1" == std::string_view((*store)[1].name.get()));
+        assert(100 == (*store)[1].counter.get());
+        assert(3 == (*store)[2].counter.get());
+        assert((*store)[0].active.get());
+        assert(0.5 == (*store)[1].balance.get());
+        assert(!(*store)[2].balance.has_value());
+
+        // a value which fits is written in place
+        (*store)[0].name.get_unsafe().set("short");
+        assert(store->checkpoint());
+    }
+
+    {
+        auto store = mapped_store<account>::open(path, 3);
+        assert(store);
+        assert("short" == std::string_view((*store)[0].name.get()));
+
+        // records deserialize like any entity, straight into the file
+        account copy;
+        char buffer[256];
+        size_t offset = 0;
+        (*store)[1].counter.set(7);
+        assert((*store)[1].serialize(buffer, sizeof(buffer), offset));
+        const size_t size = offset;
+        assert(copy.deserialize(buffer, size, offset = 0));
+        assert(7 == copy.counter.get());
+
+        copy.counter.set(8);
+        copy.active.set_has_value(false);
+        offset = 0;
+        assert(copy.serialize(buffer, sizeof(buffer), offset));
+        assert((*store)[2].deserialize(buffer, size, offset = 0));
+        assert(8 == (*store)[2].counter.get());
+    }
+
+    {
+        auto store = mapped_store<account>::open(path, 3);
+        assert(8 == (*store)[2].counter.get());
+        assert(!(*store)[2].active.has_value());
+    }
+
+    unlink(path);
+
+    // srlz members of different types are different layouts
+    {
+        auto store = mapped_store<named>::open(path, 1);
+        assert(store && store->append());
+    }
+
+    assert(!mapped_store<listed>::open(path, 1));
+    assert(mapped_store<named>::open(path, 1));
+    unlink(path);
+
+    // so are the members of the elements of a container, a type which contains itself is described once
+    {
+        auto store = mapped_store<other_list>::open(path, 1);
+        assert(store && store->append());
+    }
+
+    assert(!mapped_store<named_list>::open(path, 1));
+    assert(!mapped_store<tree>::open(path, 1));
+    assert(mapped_store<other_list>::open(path, 1));
+    unlink(path);
+
+    // a value torn by a crash fails its checksum and is loaded as absent
+    {
+        auto store = mapped_store<named>::open(path, 2);
+        assert(store && store->append() && store->append());
+        (*store)[0].value.get_unsafe().set("intact value");
+        (*store)[1].value.get_unsafe().set("torn value");
+        assert(store->checkpoint());
+    }
+
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        const std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        const size_t position = contents.find("torn value");
+        assert(position != std::string::npos);
+        file.seekp(std::streamoff(position));
+        file.put('T');
+    }
+
+    {
+        auto store = mapped_store<named>::open(path, 2);
+        assert(store && 2 == store->size());
+        assert("intact value" == std::string_view((*store)[0].value.get()));
+        assert(!(*store)[1].value.has_value());
+    }
+
+    // the value stays absent after the next open
+    {
+        auto store = mapped_store<named>::open(path, 2);
+        assert(store && !(*store)[1].value.has_value());
+    }
+
+    unlink(path);
+
+    // a record which cannot be written is not appended and the extent of its first value is given back
+    {
+        const auto append_end = [&]()
+        {
+            uint64_t end = 0;
+            const int file = ::open(path, O_RDONLY);
+            assert(pread(file, &end, sizeof(end), 5 * sizeof(uint64_t)) == sizeof(end));
+            close(file);
+
+            return end;
+        };
+
+        auto store = mapped_store<oversized>::open(path, 2, 16 * 1024);
+        assert(store);
+        const uint64_t end = append_end();
+        assert(!store->append());
+        assert(0 == store->size());
+        assert(end == append_end());
+        assert(store->checkpoint());
+    }
+
+    {
+        auto store = mapped_store<oversized>::open(path, 2, 16 * 1024);
+        assert(store && 0 == store->size());
+    }
+
+    unlink(path);
+}
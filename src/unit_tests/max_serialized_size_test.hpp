@@ -0,0 +1,118 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+
+#include "debug_helper.hpp"
+#include "srlz/array.hpp"
+#include "srlz/max_serialized_size.hpp"
+#include "srlz/serializable.hpp"
+#include "srlz/string.hpp"
+
+namespace max_serialized_size_test_entities
+{
+
+using namespace srlz;
+
+class nested_entity final : public serializable
+{
+public:
+    virtual ~nested_entity() = default;
+    nested_entity() : serializable(member_vector) {}
+
+    member<int32_t, member_type::INT_32> i;
+    member<array<uint8_t, 16>, member_type::SRLZ> hash;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&i),
+        static_cast<void*>(&hash)
+    };
+
+    static constexpr size_t max_serialized_size = srlz::max_serialized_size<decltype(i), decltype(hash)>();
+};
+
+class entity final : public serializable
+{
+public:
+    virtual ~entity() = default;
+    entity() : serializable(member_vector) {}
+
+    member<bool, member_type::BOOL> b;
+    member<double, member_type::DOUBLE> d;
+    member<nested_entity, member_type::SRLZ> nested;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&b),
+        static_cast<void*>(&d),
+        static_cast<void*>(&nested)
+    };
+
+    static constexpr size_t max_serialized_size = srlz::max_serialized_size<decltype(b), decltype(d), decltype(nested)>();
+};
+
+class named_entity final : public serializable
+{
+public:
+    virtual ~named_entity() = default;
+    named_entity() : serializable(member_vector) {}
+
+    member<int32_t, member_type::INT_32> i;
+    member<string, member_type::SRLZ> name;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&i),
+        static_cast<void*>(&name)
+    };
+};
+
+} // namespace max_serialized_size_test_entities
+
+void max_serialized_size_test()
+{
+    using namespace max_serialized_size_test_entities;
+
+    static_assert(nested_entity::max_serialized_size ==
+        sizeof(bool) + sizeof(int32_t) +
+        sizeof(bool) + sizeof(uint8_t) * 16);
+
+    static_assert(entity::max_serialized_size ==
+        sizeof(bool) + sizeof(bool) +
+        sizeof(bool) + sizeof(double) +
+        sizeof(bool) + nested_entity::max_serialized_size);
+
+    // the size declared from the member types is the one of member_vector
+    assert(entity::max_serialized_size == entity().get_max_size());
+    srlz::assert_max_serialized_size(entity());
+    assert(srlz::base::variable_size == named_entity().get_max_size());
+
+    entity first;
+    entity second;
+    first.b.set(true);
+    first.d.set(2.5);
+    first.nested.get_unsafe().i.set(15);
+    first.nested.get_unsafe().hash.get_unsafe()[0] = 1;
+    srlz::serialized_buffer<entity> buffer;
+    size_t offset;
+
+    assert(first.serialize(buffer.data(), buffer.size(), offset = 0));
+    assert(entity::max_serialized_size == offset);
+    assert(second.deserialize(buffer.data(), buffer.size(), offset = 0));
+    assert(entity::max_serialized_size == offset);
+    assert(second.b.get());
+    assert(2.5 == second.d.get());
+    assert(15 == second.nested.get().i.get());
+    assert(1 == second.nested.get().hash.get()[0]);
+
+    first.d.set_has_value(false);
+    assert(first.serialize(buffer.data(), buffer.size(), offset = 0));
+    assert(entity::max_serialized_size - sizeof(double) == offset);
+
+    //debug_helper(buffer.data(), offset);
+}
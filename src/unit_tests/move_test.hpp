@@ -0,0 +1,153 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <vector>
+
+#include "srlz/serializable.hpp"
+#include "srlz/string.hpp"
+#include "srlz/vector.hpp"
+
+void move_test()
+{
+    using namespace std::string_literals;
+
+    using namespace srlz;
+
+    class nested_entity final : public serializable
+    {
+    public:
+        virtual ~nested_entity() = default;
+        nested_entity() : serializable(member_vector) {}
+
+        nested_entity(nested_entity&& other) : nested_entity()
+        {
+            serializable::operator=(std::move(other));
+        }
+
+        member<int32_t, member_type::INT_32> i;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&i)
+        };
+
+        nested_entity& operator=(nested_entity&& other) noexcept
+        {
+            serializable::operator=(std::move(other));
+
+            return *this;
+        }
+    };
+
+    class entity final : public serializable
+    {
+    public:
+        virtual ~entity() = default;
+        entity() : serializable(member_vector) {}
+
+        entity(entity&& other) : entity()
+        {
+            serializable::operator=(std::move(other));
+        }
+
+        member<int32_t, member_type::INT_32> i;
+        member<string, member_type::SRLZ> str;
+        member<vector<nested_entity>, member_type::SRLZ> v;
+        member<nested_entity, member_type::SRLZ> nested;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&i),
+            static_cast<void*>(&str),
+            static_cast<void*>(&v),
+            static_cast<void*>(&nested)
+        };
+
+        entity& operator=(entity&& other) noexcept
+        {
+            serializable::operator=(std::move(other));
+
+            return *this;
+        }
+    };
+
+    const std::string std_string{"text that does not fit into the small string buffer"s};
+    constexpr int32_t test_value = 15;
+
+    {
+        entity first;
+        first.i.set(test_value);
+        first.str.get_unsafe().set(std_string);
+        first.v.get_unsafe().push_back(std::make_unique<nested_entity>());
+        first.v.get().back()->i.set(test_value + 1);
+        first.nested.get_unsafe().i.set(test_value + 2);
+
+        const char* const string_data = first.str.get().data();
+        const nested_entity* const item = first.v.get().back().get();
+        const nested_entity* const nested = &first.nested.get();
+        first.nested.set_has_value(false);
+
+        entity second(std::move(first));
+
+        assert(test_value == second.i.get());
+        assert(std_string == second.str.get());
+        assert(string_data == second.str.get().data());
+        assert(1 == second.v.get().size());
+        assert(item == second.v.get().back().get());
+        assert(!second.nested.has_value());
+
+        entity third;
+        third = std::move(second);
+
+        assert(test_value == third.i.get());
+        assert(string_data == third.str.get().data());
+        assert(item == third.v.get().back().get());
+        assert(test_value + 1 == third.v.get().back()->i.get());
+        third.nested.set_has_value(true);
+        assert(nested == &third.nested.get());
+        assert(test_value + 2 == third.nested.get().i.get());
+    }
+
+    {
+        std::vector<entity> entities;
+
+        for (int32_t i = 0; i < 100; ++i)
+        {
+            entities.emplace_back();
+            entities.back().i.set(i);
+            entities.back().str.get_unsafe().set(std_string);
+            entities.back().nested.get_unsafe().i.set(i * 2);
+        }
+
+        for (int32_t i = 0; i < 100; ++i)
+        {
+            assert(i == entities[i].i.get());
+            assert(std_string == entities[i].str.get());
+            assert(i * 2 == entities[i].nested.get().i.get());
+        }
+
+        constexpr size_t expected_size =
+            sizeof(bool) + sizeof(int32_t) +
+            sizeof(bool) + sizeof(size_t) + 4 +
+            sizeof(bool) + sizeof(size_t) +
+            sizeof(bool) + sizeof(bool) + sizeof(int32_t);
+
+        entity first;
+        first.str.get_unsafe().set("text"s);
+        entities.push_back(std::move(first));
+
+        char buffer[expected_size];
+        size_t offset;
+
+        assert(entities.back().serialize(buffer, expected_size, offset = 0));
+        assert(expected_size == offset);
+        assert(entities.front().deserialize(buffer, expected_size, offset = 0));
+        assert(expected_size == offset);
+        assert("text"s == entities.front().str.get());
+    }
+}
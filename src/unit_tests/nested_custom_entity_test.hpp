@@ -14,8 +14,6 @@ void nested_custom_entity_test()
 {
     using namespace srlz;
 
-    constexpr size_t size = size_t(512);
-
     class nested_entity final : public serializable
     {
     public:
@@ -32,6 +30,11 @@ void nested_custom_entity_test()
 
         std::unique_ptr<std::vector<uint32_t>> custom_vector { new std::vector<uint32_t>() };
 
+        virtual bool overrides_serialize() const noexcept override
+        {
+            return true;
+        }
+
         virtual bool serialize(
             char* const buffer,
             const size_t buffer_size,
@@ -40,11 +43,11 @@ void nested_custom_entity_test()
         {
             size_t length = custom_vector->size();
 
-            if (!write(static_cast<const void* const>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
+            if (!write(static_cast<const void*>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
                 return false;
 
             for (auto& item : *custom_vector)
-                if (!write(static_cast<const void* const>(&item), sizeof(item), buffer, buffer_size, buffer_offset))
+                if (!write(static_cast<const void*>(&item), sizeof(item), buffer, buffer_size, buffer_offset))
                     return false;
 
             return serializable::serialize(buffer, buffer_size, buffer_offset);
@@ -60,14 +63,14 @@ void nested_custom_entity_test()
 
             size_t length;
 
-            if (!read(static_cast<void* const>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
+            if (!read(static_cast<void*>(&length), sizeof(size_t), buffer, buffer_size, buffer_offset))
                 return false;
 
             for (size_t i = 0; i < length; ++i)
             {
                 uint32_t value;
 
-                if (!read(static_cast<void* const>(&value), sizeof(value), buffer, buffer_size, buffer_offset))
+                if (!read(static_cast<void*>(&value), sizeof(value), buffer, buffer_size, buffer_offset))
                     return false;
 
                 custom_vector->push_back(value);
@@ -0,0 +1,119 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <cstring>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "srlz/serializable.hpp"
+#include "srlz/static_serializable.hpp"
+#include "srlz/string.hpp"
+
+void plan_test()
+{
+    using namespace srlz;
+
+    // the static path writes member by member and serves as the reference
+    class entity final : public static_serializable<entity>
+    {
+    public:
+        virtual ~entity() = default;
+        entity() : static_serializable(member_vector) {}
+
+        member<bool, member_type::BOOL> b;
+        member<int16_t, member_type::INT_16> i16;
+        member<uint64_t, member_type::U_INT_64> u64;
+        member<string, member_type::SRLZ> str;
+        member<float, member_type::FLOAT> f;
+        member<long double, member_type::LONG_DOUBLE> ld;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&b),
+            static_cast<void*>(&i16),
+            static_cast<void*>(&u64),
+            static_cast<void*>(&str),
+            static_cast<void*>(&f),
+            static_cast<void*>(&ld)
+        };
+
+        static constexpr auto members()
+        {
+            return std::make_tuple(&entity::b, &entity::i16, &entity::u64, &entity::str, &entity::f, &entity::ld);
+        }
+    };
+
+    entity first;
+    first.b.set(true);
+    first.i16.set(-2);
+    first.u64.set(UINT64_MAX - 1);
+    first.str.get_unsafe().set("plan");
+    first.f.set(0.5f);
+    first.ld.set(2.5L);
+
+    for (const bool absent : { false, true })
+    {
+        first.i16.set_has_value(!absent);
+        first.f.set_has_value(!absent);
+
+        char expected[128];
+        size_t offset = 0;
+        assert(first.entity::serialize(expected, sizeof(expected), offset));
+        const size_t size = offset;
+
+        char buffer[128];
+        offset = 0;
+        assert(first.serializable::serialize(buffer, sizeof(buffer), offset));
+        assert(size == offset);
+        assert(0 == std::memcmp(expected, buffer, size));
+
+        // exact and short buffers take the checked path of a run
+        for (size_t length = 0; length <= size; ++length)
+        {
+            offset = 0;
+            const bool success = first.serializable::serialize(buffer, length, offset);
+            assert(success == (length == size));
+
+            if (success)
+                assert(0 == std::memcmp(expected, buffer, size));
+
+            entity second;
+            offset = 0;
+            assert((length == size) == second.serializable::deserialize(expected, length, offset));
+        }
+
+        entity second;
+        offset = 0;
+        assert(second.serializable::deserialize(expected, size, offset));
+        assert(size == offset);
+        assert(absent != second.i16.has_value());
+        assert(absent != second.f.has_value());
+        assert(UINT64_MAX - 1 == second.u64.get());
+        assert(2.5L == second.ld.get());
+
+        if (!absent)
+            assert(-2 == second.i16.get());
+    }
+
+    // instances built on several threads share one plan of their class
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([]()
+        {
+            entity value;
+            char buffer[128];
+            size_t offset = 0;
+            const bool success = value.serializable::serialize(buffer, sizeof(buffer), offset);
+            assert(success);
+        });
+
+    for (auto& thread : threads)
+        thread.join();
+}
@@ -0,0 +1,198 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <thread>
+#include <vector>
+
+#include "srlz/max_serialized_size.hpp"
+#include "srlz/ring.hpp"
+#include "srlz/serializable.hpp"
+#include "srlz/string.hpp"
+
+namespace ring_test_entities
+{
+
+using namespace srlz;
+
+class message final : public serializable
+{
+public:
+    virtual ~message() = default;
+    message() : serializable(member_vector) {}
+
+    member<uint32_t, member_type::U_INT_32> producer;
+    member<uint64_t, member_type::U_INT_64> sequence;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&producer),
+        static_cast<void*>(&sequence)
+    };
+
+    static constexpr size_t max_serialized_size = srlz::max_serialized_size<decltype(producer), decltype(sequence)>();
+};
+
+class text_message final : public serializable
+{
+public:
+    virtual ~text_message() = default;
+    text_message() : serializable(member_vector) {}
+
+    member<uint64_t, member_type::U_INT_64> sequence;
+    member<string, member_type::SRLZ> text;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&sequence),
+        static_cast<void*>(&text)
+    };
+};
+
+} // namespace ring_test_entities
+
+void ring_test()
+{
+    using namespace ring_test_entities;
+
+    {
+        spsc_ring channel(256);
+        text_message first;
+        text_message second;
+        assert(channel.empty());
+        assert(!channel.try_pop(second));
+
+        size_t pushed = 0;
+        size_t popped = 0;
+
+        // sizes vary so that records wrap around the end of the ring at different offsets
+        for (uint64_t i = 0; i < 1000; ++i)
+        {
+            first.sequence.set(i);
+            first.text.get_unsafe().set(std::string(i % 50, char('a' + i % 26)));
+
+            while (!channel.try_push(first, 128))
+            {
+                assert(channel.try_pop(second));
+                assert(popped == second.sequence.get());
+                assert(popped % 50 == second.text.get().length());
+                ++popped;
+            }
+
+            ++pushed;
+        }
+
+        while (channel.try_pop(second))
+        {
+            assert(popped == second.sequence.get());
+            ++popped;
+        }
+
+        assert(pushed == popped);
+        assert(channel.empty());
+
+        first.text.get_unsafe().set(std::string(200, 'a'));
+        assert(!channel.try_push(first, 512));
+        assert(channel.empty());
+        assert(!channel.try_push(first, 128));
+        assert(!channel.try_pop(second));
+        assert(channel.empty());
+
+        auto slot = channel.try_reserve(16);
+        assert(slot.data && slot.size >= 16);
+        channel.commit(slot, 0, true);
+        assert(!channel.try_pop(second));
+        assert(channel.empty());
+    }
+
+    // a record larger than half of the ring, the end of the ring is skipped first
+    {
+        const auto reserve_large = [](auto& channel)
+        {
+            auto slot = channel.try_reserve(512);
+            assert(slot.data);
+            channel.commit(slot, 512);
+            assert(channel.peek().size == 512);
+            channel.release();
+            assert(channel.empty() && channel.fits(600));
+
+            slot = channel.try_reserve(600);
+
+            if (!slot.data)
+            {
+                assert(!channel.peek().data);
+                slot = channel.try_reserve(600);
+            }
+
+            assert(slot.data && slot.size >= 600);
+            channel.commit(slot, 600);
+            assert(channel.peek().size == 600);
+            channel.release();
+            assert(channel.empty());
+        };
+
+        spsc_ring single(1024);
+        reserve_large(single);
+
+        mpsc_ring multiple(1024);
+        reserve_large(multiple);
+    }
+
+    {
+        constexpr uint32_t producers = 4;
+        constexpr uint64_t count = 20000;
+
+        mpsc_ring channel(4096);
+        std::vector<std::thread> threads;
+
+        for (uint32_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&channel, p]
+            {
+                message m;
+                m.producer.set(p);
+
+                for (uint64_t i = 0; i < count; ++i)
+                {
+                    m.sequence.set(i);
+
+                    while (!channel.try_push(m))
+                        std::this_thread::yield();
+                }
+            });
+        }
+
+        std::vector<uint64_t> expected(producers, 0);
+        message m;
+
+        for (uint64_t received = 0; received < producers * count;)
+        {
+            auto record = channel.peek();
+
+            if (!record.data)
+            {
+                std::this_thread::yield();
+
+                continue;
+            }
+
+            size_t offset = 0;
+            assert(m.deserialize(record.data, record.size, offset));
+            assert(message::max_serialized_size == record.size);
+            channel.release();
+
+            assert(expected[m.producer.get()] == m.sequence.get());
+            ++expected[m.producer.get()];
+            ++received;
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        assert(channel.empty());
+    }
+}
@@ -0,0 +1,132 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "srlz/columnar.hpp"
+#include "srlz/scan.hpp"
+#include "srlz/serializable.hpp"
+
+namespace scan_test_entities
+{
+
+using namespace srlz;
+
+class trade final : public serializable
+{
+public:
+    virtual ~trade() = default;
+    trade() : serializable(member_vector) {}
+
+    member<int32_t, member_type::INT_32> flags;
+    member<int64_t, member_type::INT_64> id;
+    member<float, member_type::FLOAT> quantity;
+    member<double, member_type::DOUBLE> price;
+    member<uint16_t, member_type::U_INT_16> venue;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&flags),
+        static_cast<void*>(&id),
+        static_cast<void*>(&quantity),
+        static_cast<void*>(&price),
+        static_cast<void*>(&venue)
+    };
+};
+
+/**
+ * @brief every instruction set has to find exactly what the scalar predicate finds
+ */
+template<typename T>
+void check_scan(const column_view<T>& column, const predicate<T>& condition, const size_t expected)
+{
+    std::vector<size_t> reference;
+
+    for (size_t i = 0; i < column.size(); ++i)
+        if (column.has_value(i) && condition(column[i]))
+            reference.push_back(i);
+
+    assert(expected == reference.size());
+
+    for (const auto isa : { scan_isa::SCALAR, scan_isa::SSE2, scan_isa::AVX2 })
+    {
+        std::vector<size_t> matches;
+
+        assert(reference.size() == scan(column, condition, matches, isa));
+        assert(reference == matches);
+    }
+}
+
+} // namespace scan_test_entities
+
+void scan_test()
+{
+    using namespace scan_test_entities;
+
+    // not a multiple of any vector width, so the scalar tail is used too
+    constexpr size_t count = 1003;
+
+    columnar<trade> batch;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        batch.push_back(std::make_unique<trade>());
+        batch.back()->flags.set(int32_t(i % 16));
+        batch.back()->id.set(int64_t(i) - 500);
+        batch.back()->quantity.set(float(i % 100));
+        batch.back()->price.set(i == 7 ? std::nan("") : double(i) * 0.5);
+        batch.back()->venue.set(uint16_t(i % 5));
+        batch.back()->id.set_has_value(i % 9 != 0);
+    }
+
+    std::vector<uint64_t> storage(count * 4);
+    char* const buffer = reinterpret_cast<char*>(storage.data());
+    size_t offset;
+
+    assert(batch.serialize(buffer, storage.size() * sizeof(uint64_t), offset = 0));
+
+    columnar<trade>::view parsed;
+    const size_t size = offset;
+
+    assert(columnar<trade>::parse(buffer, size, offset = 0, parsed));
+
+    const auto flags = parsed.column<int32_t>(0);
+    const auto ids = parsed.column<int64_t>(1);
+    const auto quantities = parsed.column<float>(2);
+    const auto prices = parsed.column<double>(3);
+    const auto venues = parsed.column<uint16_t>(4);
+
+    check_scan(flags, predicate<int32_t>::equal(3), 63);
+    check_scan(flags, predicate<int32_t>::less(2), 126);
+    check_scan(flags, predicate<int32_t>::range(4, 5), 126);
+    check_scan(flags, predicate<int32_t>::bitmask(8), 499);
+    check_scan(ids, predicate<int64_t>::greater(400), 91);
+    check_scan(ids, predicate<int64_t>::range(-10, 10), 19);
+    check_scan(ids, predicate<int64_t>::bitmask(1), 445);
+    check_scan(quantities, predicate<float>::range(10.0F, 19.0F), 100);
+    check_scan(quantities, predicate<float>::equal(99.0F), 10);
+    check_scan(prices, predicate<double>::less(5.0), 9);
+    check_scan(prices, predicate<double>::range(0.0, 1000.0), 1002);
+    check_scan(venues, predicate<uint16_t>::equal(4), 200);
+
+    // only the matches are deserialized
+    std::vector<size_t> matches;
+    scan(ids, predicate<int64_t>::greater(495), matches);
+    assert(6 == matches.size());
+
+    trade item;
+
+    for (auto index : matches)
+    {
+        parsed.extract(index, item);
+        assert(int64_t(index) - 500 == item.id.get());
+        assert(int32_t(index % 16) == item.flags.get());
+    }
+}
@@ -0,0 +1,115 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+#include "srlz/array.hpp"
+#include "srlz/max_serialized_size.hpp"
+#include "srlz/seqlock.hpp"
+#include "srlz/serializable.hpp"
+
+namespace seqlock_test_entities
+{
+
+using namespace srlz;
+
+class quote final : public serializable
+{
+public:
+    virtual ~quote() = default;
+    quote() : serializable(member_vector) {}
+
+    member<int64_t, member_type::INT_64> bid;
+    member<int64_t, member_type::INT_64> ask;
+    member<array<int64_t, 8>, member_type::SRLZ> depth;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&bid),
+        static_cast<void*>(&ask),
+        static_cast<void*>(&depth)
+    };
+
+    static constexpr size_t max_serialized_size = srlz::max_serialized_size<decltype(bid), decltype(ask), decltype(depth)>();
+};
+
+} // namespace seqlock_test_entities
+
+void seqlock_test()
+{
+    using namespace seqlock_test_entities;
+
+    constexpr int64_t updates = 100000;
+
+    seqlock<quote> shared;
+    std::atomic<bool> stop = false;
+
+    std::thread writer([&shared, &stop]
+    {
+        for (int64_t i = 1; i <= updates; ++i)
+        {
+            shared.update([i](quote& q)
+            {
+                q.bid.set(i);
+                q.ask.set(i + 1);
+
+                for (auto& level : q.depth.get_unsafe())
+                    level = i;
+            });
+        }
+
+        stop = true;
+    });
+
+    std::vector<std::thread> readers;
+
+    for (size_t r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&shared, &stop]
+        {
+            serialized_buffer<seqlock<quote>> buffer;
+            quote snapshot;
+            int64_t previous = 0;
+
+            while (!stop)
+            {
+                size_t offset = 0;
+                assert(shared.serialize(buffer.data(), buffer.size(), offset));
+                assert(quote::max_serialized_size == offset);
+                assert(snapshot.deserialize(buffer.data(), buffer.size(), offset = 0));
+
+                const int64_t bid = snapshot.bid.get();
+                assert(bid + 1 == snapshot.ask.get());
+                assert(bid >= previous);
+
+                for (auto level : snapshot.depth.get())
+                    assert(bid == level);
+
+                previous = bid;
+            }
+        });
+    }
+
+    writer.join();
+
+    for (auto& reader : readers)
+        reader.join();
+
+    serialized_buffer<quote> buffer;
+    size_t offset = 0;
+    quote last;
+    assert(shared.serialize(buffer.data(), buffer.size(), offset));
+    assert(last.deserialize(buffer.data(), buffer.size(), offset = 0));
+    assert(updates == last.bid.get());
+
+    seqlock<quote> copy;
+    assert(copy.deserialize(buffer.data(), buffer.size(), offset = 0));
+    assert(updates + 1 == copy.get().ask.get());
+}
@@ -18,11 +18,36 @@
 #include "custom_entity_test.hpp"
 #include "nested_custom_entity_test.hpp"
 #include "vector_test.hpp"
+#include "map_test.hpp"
+#include "array_test.hpp"
+#include "variant_test.hpp"
+#include "max_serialized_size_test.hpp"
+#include "gather_test.hpp"
+#include "async_writer_test.hpp"
+#include "chunked_test.hpp"
+#include "seqlock_test.hpp"
+#include "ring_test.hpp"
+#include "shm_channel_test.hpp"
+#include "limits_test.hpp"
+#include "blob_test.hpp"
+#include "allocator_test.hpp"
+#include "dictionary_test.hpp"
+#include "columnar_test.hpp"
+#include "scan_test.hpp"
+#include "canonical_test.hpp"
+#include "cached_test.hpp"
+#include "footprint_test.hpp"
+#include "static_serializable_test.hpp"
+#include "plan_test.hpp"
+#include "mapped_store_test.hpp"
+#include "wal_test.hpp"
+#include "framed_test.hpp"
 #include "copy_assignment_operator_test.hpp"
+#include "move_test.hpp"
 
 using namespace std::string_view_literals;
 
-int main(int argc, char* argv[])
+int main()
 {
     const std::initializer_list<std::pair<void (*)(), std::string_view>> tests = 
     {
@@ -34,10 +59,35 @@ int main(int argc, char* argv[])
         {memory_test, "memory_test"sv},
         {string_test, "string_test"sv},
         {vector_test, "vector_test"sv},
+        {map_test, "map_test"sv},
+        {array_test, "array_test"sv},
+        {variant_test, "variant_test"sv},
+        {max_serialized_size_test, "max_serialized_size_test"sv},
+        {gather_test, "gather_test"sv},
+        {async_writer_test, "async_writer_test"sv},
+        {chunked_test, "chunked_test"sv},
+        {seqlock_test, "seqlock_test"sv},
+        {ring_test, "ring_test"sv},
+        {shm_channel_test, "shm_channel_test"sv},
+        {limits_test, "limits_test"sv},
+        {blob_test, "blob_test"sv},
+        {allocator_test, "allocator_test"sv},
+        {dictionary_test, "dictionary_test"sv},
+        {columnar_test, "columnar_test"sv},
+        {scan_test, "scan_test"sv},
+        {canonical_test, "canonical_test"sv},
+        {cached_test, "cached_test"sv},
+        {footprint_test, "footprint_test"sv},
+        {static_serializable_test, "static_serializable_test"sv},
+        {plan_test, "plan_test"sv},
+        {mapped_store_test, "mapped_store_test"sv},
+        {wal_test, "wal_test"sv},
+        {framed_test, "framed_test"sv},
         {custom_entity_test, "custom_entity_test"sv},
         {nested_entity_test, "nested_entity_test"sv},
         {nested_custom_entity_test, "nested_custom_entity_test"sv},
         {copy_assignment_operator_test, "copy_assignment_operator_test"sv},
+        {move_test, "move_test"sv},
     };
 
     for (auto& [test, name] : tests)
@@ -0,0 +1,184 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "srlz/max_serialized_size.hpp"
+#include "srlz/serializable.hpp"
+#include "srlz/shm_channel.hpp"
+
+namespace shm_channel_test_entities
+{
+
+using namespace srlz;
+
+class message final : public serializable
+{
+public:
+    virtual ~message() = default;
+    message() : serializable(member_vector) {}
+
+    member<uint64_t, member_type::U_INT_64> sequence;
+    member<double, member_type::DOUBLE> value;
+
+    serializable::member_vector_type member_vector =
+    {
+        static_cast<void*>(&sequence),
+        static_cast<void*>(&value)
+    };
+
+    static constexpr size_t max_serialized_size = srlz::max_serialized_size<decltype(sequence), decltype(value)>();
+};
+
+} // namespace shm_channel_test_entities
+
+void shm_channel_test()
+{
+    using namespace shm_channel_test_entities;
+
+    const std::string name = "/srlz_shm_channel_test_" + std::to_string(getpid());
+    constexpr uint64_t count = 100000;
+
+    {
+        auto receiver = shm_channel<>::create(name.c_str(), 1024);
+        assert(receiver);
+        assert(!shm_channel<>::create(name.c_str(), 1024));
+
+        // the ring is much smaller than the stream, so the sender sleeps on a full ring many times
+        const pid_t child = fork();
+        assert(child >= 0);
+
+        if (child == 0)
+        {
+            auto sender = shm_channel<>::open(name.c_str());
+
+            if (!sender)
+                _exit(1);
+
+            message item;
+
+            for (uint64_t i = 0; i < count; ++i)
+            {
+                item.sequence.set(i);
+                item.value.set(double(i) / 2);
+
+                if (!sender->send(item))
+                    _exit(2);
+            }
+
+            _exit(0);
+        }
+
+        message item;
+
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            assert(receiver->receive(item));
+            assert(i == item.sequence.get());
+            assert(double(i) / 2 == item.value.get());
+        }
+
+        int status;
+        assert(waitpid(child, &status, 0) == child);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        assert(!receiver->try_receive(item));
+    }
+
+    {
+        auto receiver = shm_channel<producer_mode::MULTIPLE>::create(name.c_str(), 4096);
+        assert(receiver);
+
+        constexpr int senders = 3;
+        constexpr uint64_t sender_count = 10000;
+
+        for (int s = 0; s < senders; ++s)
+        {
+            if (fork() != 0)
+                continue;
+
+            auto sender = shm_channel<producer_mode::MULTIPLE>::open(name.c_str());
+
+            if (!sender)
+                _exit(1);
+
+            message item;
+
+            for (uint64_t i = 0; i < sender_count; ++i)
+            {
+                item.sequence.set(i);
+                item.value.set(double(s));
+
+                if (!sender->send(item))
+                    _exit(2);
+            }
+
+            _exit(0);
+        }
+
+        uint64_t next[senders] = {};
+
+        for (uint64_t i = 0; i < senders * sender_count; ++i)
+        {
+            // views are read in place without a copy out of the segment
+            const auto view = receiver->wait_peek();
+            message item;
+            size_t offset = 0;
+            assert(item.deserialize(view.data, view.size, offset));
+            receiver->release();
+
+            const int s = int(item.value.get());
+            assert(next[s]++ == item.sequence.get());
+        }
+
+        for (int s = 0; s < senders; ++s)
+        {
+            int status;
+            assert(wait(&status) > 0);
+            assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        }
+    }
+
+    {
+        auto receiver = shm_channel<>::create(name.c_str(), 1024);
+        assert(receiver);
+
+        // the second message is larger than the space left at the end of the ring, so the sender
+        // skips the end and sleeps until the receiver has passed it
+        const pid_t child = fork();
+        assert(child >= 0);
+
+        if (child == 0)
+        {
+            auto sender = shm_channel<>::open(name.c_str());
+            message item;
+
+            if (!sender || !sender->send(item, 512) || !sender->send(item, 600))
+                _exit(1);
+
+            _exit(0);
+        }
+
+        // a hang fails the test
+        alarm(10);
+
+        message item;
+        assert(receiver->receive(item));
+        assert(receiver->receive(item));
+
+        alarm(0);
+
+        int status;
+        assert(waitpid(child, &status, 0) == child);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+
+    assert(!shm_channel<>::open(name.c_str()));
+}
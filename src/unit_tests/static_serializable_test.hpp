@@ -0,0 +1,139 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <string_view>
+#include <tuple>
+
+#include "srlz/canonical.hpp"
+#include "srlz/serializable.hpp"
+#include "srlz/static_serializable.hpp"
+#include "srlz/string.hpp"
+#include "srlz/vector.hpp"
+
+void static_serializable_test()
+{
+    using namespace srlz;
+
+    class point final : public static_serializable<point>
+    {
+    public:
+        virtual ~point() = default;
+        point() : static_serializable(member_vector) {}
+
+        member<int32_t, member_type::INT_32> x;
+        member<double, member_type::DOUBLE> y;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&x),
+            static_cast<void*>(&y)
+        };
+
+        static constexpr auto members()
+        {
+            return std::make_tuple(&point::x, &point::y);
+        }
+    };
+
+    class shape final : public static_serializable<shape>
+    {
+    public:
+        virtual ~shape() = default;
+        shape() : static_serializable(member_vector) {}
+
+        member<string, member_type::SRLZ> name;
+        member<point, member_type::SRLZ> center;
+        member<vector<point>, member_type::SRLZ> points;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&name),
+            static_cast<void*>(&center),
+            static_cast<void*>(&points)
+        };
+
+        static constexpr auto members()
+        {
+            return std::make_tuple(&shape::name, &shape::center, &shape::points);
+        }
+    };
+
+    shape first;
+    first.name.get_unsafe().set("triangle");
+    first.center.get_unsafe().x.set(1);
+    first.center.get_unsafe().y.set(-0.0);
+
+    for (int32_t i = 0; i < 3; ++i)
+    {
+        auto& points = first.points.get_unsafe();
+        points.push_back(points.make_item());
+        points.back()->x.set(i);
+        points.back()->y.set(i * 0.5);
+    }
+
+    first.points.get_unsafe()[1]->y.set_has_value(false);
+
+    char buffer[512];
+    size_t offset = 0;
+    assert(first.shape::serialize(buffer, sizeof(buffer), offset));
+    const size_t size = offset;
+
+    // the same bytes as the virtual path
+    char expected[512];
+    offset = 0;
+    assert(first.serializable::serialize(expected, sizeof(expected), offset));
+    assert(size == offset);
+    assert(0 == std::memcmp(expected, buffer, size));
+
+    offset = 0;
+    assert(!first.serialize(buffer, size - 1, offset));
+
+    shape second;
+    offset = 0;
+    assert(second.deserialize(buffer, size, offset));
+    assert(size == offset);
+    assert("triangle" == std::string_view(second.name.get()));
+    assert(1 == second.center.get().x.get());
+    assert(3 == second.points.get().size());
+    assert(2 == second.points.get()[2]->x.get());
+    assert(!second.points.get()[1]->y.has_value());
+
+    // through the base class
+    const serializable& as_base = second;
+    offset = 0;
+    assert(as_base.serialize(expected, sizeof(expected), offset));
+    assert(size == offset);
+    assert(0 == std::memcmp(expected, buffer, size));
+
+    offset = 0;
+    assert(!second.deserialize(buffer, size - 1, offset));
+
+    // a cached entity and a canonical_scope take the path of serializable
+    first.enable_cache();
+    offset = 0;
+    assert(first.serialize(expected, sizeof(expected), offset));
+    assert(first.is_cached());
+    first.center.get_unsafe().x.set(2);
+    assert(!first.is_cached());
+
+    {
+        canonical_scope scope(false);
+        offset = 0;
+        assert(first.serialize(expected, sizeof(expected), offset));
+
+        // name, then center.x and the has_value of center.y
+        const size_t y_offset = sizeof(bool) + sizeof(size_t) + std::strlen("triangle")
+            + sizeof(bool) + sizeof(bool) + sizeof(int32_t) + sizeof(bool);
+
+        double y;
+        std::memcpy(&y, expected + y_offset, sizeof(double));
+        assert(0.0 == y && !std::signbit(y));
+    }
+}
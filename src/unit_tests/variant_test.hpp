@@ -0,0 +1,132 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <utility>
+
+#include "debug_helper.hpp"
+#include "srlz/serializable.hpp"
+#include "srlz/string.hpp"
+#include "srlz/variant.hpp"
+
+void variant_test()
+{
+    using namespace std::string_literals;
+
+    using namespace srlz;
+
+    class login_event final : public serializable
+    {
+    public:
+        virtual ~login_event() = default;
+        login_event() : serializable(member_vector) {}
+
+        member<string, member_type::SRLZ> user;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&user)
+        };
+    };
+
+    class trade_event final : public serializable
+    {
+    public:
+        virtual ~trade_event() = default;
+        trade_event() : serializable(member_vector) {}
+
+        member<int64_t, member_type::INT_64> quantity;
+        member<double, member_type::DOUBLE> price;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&quantity),
+            static_cast<void*>(&price)
+        };
+    };
+
+    class envelope final : public serializable
+    {
+    public:
+        virtual ~envelope() = default;
+        envelope() : serializable(member_vector) {}
+
+        member<uint64_t, member_type::U_INT_64> sequence;
+        member<variant<login_event, trade_event>, member_type::SRLZ> event;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&sequence),
+            static_cast<void*>(&event)
+        };
+    };
+
+    static_assert(std::is_same_v<variant<login_event, trade_event>::index_type, uint8_t>);
+    static_assert(variant<login_event, trade_event>::index_of<trade_event>() == 1);
+
+    {
+        envelope first;
+        assert(0 == first.event.get().index());
+        assert(nullptr != first.event.get().get_if<login_event>());
+        assert(nullptr == first.event.get().get_if<trade_event>());
+    }
+
+    envelope first;
+    envelope second;
+    first.sequence.set(15);
+    auto& trade = first.event.get_unsafe().emplace<trade_event>();
+    trade.quantity.set(100);
+    trade.price.set(2.5);
+
+    constexpr size_t expected_size =
+        sizeof(bool) + sizeof(uint64_t) +
+        sizeof(bool) + sizeof(uint8_t) +
+        sizeof(bool) + sizeof(int64_t) +
+        sizeof(bool) + sizeof(double);
+
+    char buffer[expected_size];
+    size_t offset;
+
+    assert(first.serialize(buffer, expected_size, offset = 0));
+    assert(expected_size == offset);
+    assert(second.deserialize(buffer, expected_size, offset = 0));
+    assert(expected_size == offset);
+    assert(1 == second.event.get().index());
+    assert(nullptr == second.event.get().get_if<login_event>());
+
+    const trade_event* const decoded = second.event.get().get_if<trade_event>();
+    assert(nullptr != decoded);
+    assert(100 == decoded->quantity.get());
+    assert(2.5 == decoded->price.get());
+
+    assert(second.deserialize(buffer, expected_size, offset = 0));
+    assert(decoded == second.event.get().get_if<trade_event>());
+
+    first.event.get_unsafe().emplace<login_event>().user.get_unsafe().set("user"s);
+    const size_t login_size = sizeof(bool) + sizeof(uint64_t) + sizeof(bool) + sizeof(uint8_t) + sizeof(bool) + sizeof(size_t) + 4;
+    assert(first.serialize(buffer, expected_size, offset = 0));
+    assert(login_size == offset);
+    assert(second.deserialize(buffer, login_size, offset = 0));
+    assert("user"s == second.event.get().get_if<login_event>()->user.get());
+
+    buffer[sizeof(bool) + sizeof(uint64_t) + sizeof(bool)] = 2;
+    assert(!second.deserialize(buffer, login_size, offset = 0));
+
+    // a moved-from variant still holds a value
+    variant<login_event, trade_event> moved;
+    moved.emplace<trade_event>().quantity.set(7);
+    variant<login_event, trade_event> target(std::move(moved));
+    assert(7 == target.get_if<trade_event>()->quantity.get());
+    assert(0 == moved.index() && moved.get_if<login_event>());
+    assert(moved.serialize(buffer, expected_size, offset = 0));
+
+    moved = std::move(target);
+    assert(1 == moved.index() && 0 == target.index());
+    assert(target.serialize(buffer, expected_size, offset = 0));
+
+    //debug_helper(buffer, serialize_offset);
+}
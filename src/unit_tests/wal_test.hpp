@@ -0,0 +1,142 @@
+/**
+ * @brief project serializable
+ * @author Ilya Shishkin (cortl@yandex.ru)
+ * @license GPL v3.0
+ * @copyright Copyright (c) 2022
+ */
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "srlz/serializable.hpp"
+#include "srlz/string.hpp"
+#include "srlz/wal.hpp"
+
+void wal_test()
+{
+    using namespace srlz;
+
+    class change final : public serializable
+    {
+    public:
+        virtual ~change() = default;
+        change() : serializable(member_vector) {}
+
+        member<int32_t, member_type::INT_32> writer;
+        member<int32_t, member_type::INT_32> sequence;
+        member<string, member_type::SRLZ> note;
+
+        serializable::member_vector_type member_vector =
+        {
+            static_cast<void*>(&writer),
+            static_cast<void*>(&sequence),
+            static_cast<void*>(&note)
+        };
+    };
+
+    char path[] = "/tmp/srlz_wal_XXXXXX";
+    const int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+
+    constexpr int writers = 4;
+    constexpr int count = 50;
+
+    {
+        wal log(path);
+        assert(log.is_open());
+
+        std::vector<std::thread> threads;
+
+        for (int w = 0; w < writers; ++w)
+            threads.emplace_back([&log, w]()
+            {
+                change record;
+                record.writer.set(w);
+                record.note.get_unsafe().set(std::string(size_t(w) * 100, 'w'));
+
+                for (int i = 0; i < count; ++i)
+                {
+                    record.sequence.set(i);
+                    const bool success = log.append(record);
+                    assert(success);
+                }
+            });
+
+        for (auto& thread : threads)
+            thread.join();
+
+        assert(writers * count == log.get_durable_count());
+    }
+
+    // records of a writer keep their order
+    const auto check = [&path](const int expected)
+    {
+        wal_reader reader(path);
+        assert(reader.is_open());
+
+        std::vector<int> next(writers, 0);
+        wal_reader::record_view view;
+        change record;
+        int total = 0;
+
+        while (reader.next(view))
+        {
+            assert(view.deserialize(record));
+
+            const int w = record.writer.get();
+            assert(record.note.get().size() == size_t(w) * 100);
+
+            if (w < writers)
+                assert(next[w]++ == record.sequence.get());
+
+            ++total;
+        }
+
+        assert(expected == total);
+
+        return reader.get_offset();
+    };
+
+    const size_t valid_size = check(writers * count);
+
+    // a torn tail is ignored by the reader and cut off by the log
+    {
+        std::FILE* const file = std::fopen(path, "ab");
+        const char torn[] = { 20, 0, 0, 0, 1, 2, 3, 4, 5, 6 };
+        std::fwrite(torn, 1, sizeof(torn), file);
+        std::fclose(file);
+    }
+
+    assert(valid_size == check(writers * count));
+
+    {
+        wal log(path);
+        assert(log.is_open());
+
+        change record;
+        record.writer.set(writers);
+        record.sequence.set(0);
+        record.note.get_unsafe().set(std::string(size_t(writers) * 100, 'x'));
+        assert(log.append(record));
+    }
+
+    assert(valid_size < check(writers * count + 1));
+
+    // a corrupted record ends the log
+    {
+        std::FILE* const file = std::fopen(path, "r+b");
+        std::fseek(file, long(sizeof(wal_frame)), SEEK_SET);
+        std::fputc(0x7F, file);
+        std::fclose(file);
+    }
+
+    assert(0 == check(0));
+
+    unlink(path);
+}